@@ -0,0 +1,144 @@
+//File: Bytecode.h
+#ifndef BYTECODE_H
+#define BYTECODE_H
+#include <string>
+#include <vector>
+#include "Value.h"
+#include "types_and_ops.h"
+
+class Expression;
+class Binary_operator;
+class Unary_operator;
+class Variable;
+
+// A Bytecode is a finished Expression tree lowered to a flat list of
+// register instructions.  Opcodes are specialized on their operand types
+// (INT_ADD, DBL_ADD, STR_CONCAT, ...) so run() makes no virtual calls and
+// never asks a node for its type.  Operands live in three typed register
+// files and literals are loaded into their registers once, by the compiler.
+// A variable is loaded straight from symbol_storage at its symbol's offset
+// (INT_LOAD, ...); an array element evaluates its index into a register
+// first and is loaded from there (INT_LOAD_ELEMENT, ...).
+//
+// A node without an opcode of its own (a variable that is undeclared or
+// a whole array, && or || on a string) is run through its own value() by
+// a NODE_* instruction, so it still reports the same errors; none of them
+// evaluates its operands.  A builtin given a string evaluates the string
+// here and reports it with BAD_OPERAND, as its value() would.
+//
+// Every statement of a Statement_block is compiled to a Bytecode once,
+// when the block is built, and run from there.  Expression::evaluate()
+// compiles one for a tree deeper than Expression::RECURSION_LIMIT, which
+// it keeps with the tree.  The tree is compiled without recursion and
+// run() only recurses into the nodes it runs through value(), so a tree of
+// any depth can be evaluated here.  run() gives the same results and
+// reports the same errors as value(), except that a node that reported an
+// error and gave no value ends the run with no value.
+//
+// The tree and the symbols its variables name must outlive its Bytecode.
+class Bytecode {
+  public:
+    // as, if given, is a type the result converts to (gamelang::converts_to)
+    // and is the type it is left in
+    explicit Bytecode(const Expression* expr, gamelang::Type as = gamelang::NO_TYPE);
+    Value run();
+    // execute() runs the code and leaves the result in its register, where
+    // int_result() and the others read it without building a Value; false
+    // if a node reported an error and gave no value
+    bool execute();
+    Value result() const;   // of the last execute()
+    int int_result() const { return int_registers[result_register]; }
+    double double_result() const { return double_registers[result_register]; }
+    const std::string& string_result() const { return string_registers[result_register]; }
+    gamelang::Type type() const { return result_type; }
+    int size() const { return code.size(); }
+
+    Bytecode(const Bytecode&) = delete;
+    Bytecode& operator=(const Bytecode&) = delete;
+
+#define GPL_OPCODES(X) \
+    X(HALT) \
+    X(NODE_INT) X(NODE_DOUBLE) X(NODE_STRING) \
+    X(INT_LOAD) X(DBL_LOAD) X(STR_LOAD) \
+    X(INT_LOAD_ELEMENT) X(DBL_LOAD_ELEMENT) X(STR_LOAD_ELEMENT) \
+    X(JUMP_IF_ZERO) X(JUMP_IF_NOT_ZERO) \
+    X(INT_ADD) X(INT_SUB) X(INT_MUL) X(INT_DIV) X(INT_MOD) \
+    X(INT_NEG) X(INT_ABS) X(INT_NOT) X(INT_TRUTH) \
+    X(INT_LT) X(INT_LE) X(INT_GT) X(INT_GE) X(INT_EQ) X(INT_NE) \
+    X(INT_TO_DBL) X(INT_TO_STR) \
+    X(DBL_ADD) X(DBL_SUB) X(DBL_MUL) X(DBL_DIV) \
+    X(DBL_NEG) X(DBL_ABS) X(DBL_NOT) X(DBL_TRUTH) \
+    X(DBL_LT) X(DBL_LE) X(DBL_GT) X(DBL_GE) X(DBL_EQ) X(DBL_NE) \
+    X(DBL_SIN) X(DBL_COS) X(DBL_TAN) X(DBL_ASIN) X(DBL_ACOS) X(DBL_ATAN) \
+    X(DBL_SQRT) X(DBL_FLOOR) X(DBL_TO_STR) \
+    X(INT_RANDOM) X(DBL_RANDOM) X(BAD_OPERAND) \
+    X(STR_CONCAT) X(STR_APPEND) \
+    X(STR_LT) X(STR_LE) X(STR_GT) X(STR_GE) X(STR_EQ) X(STR_NE)
+
+#define GPL_OPCODE_ENUM(name) name,
+    enum Opcode : unsigned char { GPL_OPCODES(GPL_OPCODE_ENUM) };
+#undef GPL_OPCODE_ENUM
+
+  private:
+    // dst, a and b index the register file selected by the opcode;
+    // a jump keeps its condition register in a and its target in b,
+    // a NODE_* or BAD_OPERAND instruction keeps its node index in a;
+    // a *_LOAD keeps the variable's offset in symbol_storage in a, a
+    // *_LOAD_ELEMENT its index register (of its array's index_type) in a
+    // and its array, an index into arrays, in b;
+    // STR_APPEND appends b to dst (== a), a temporary built by the
+    // STR_CONCAT or STR_APPEND just before it, so a chain of string
+    // additions grows one string instead of copying it at every step
+    struct Instruction {
+      Opcode op;
+      int dst;
+      int a;
+      int b;
+    };
+
+    // an array element a *_LOAD_ELEMENT reads
+    struct Array {
+      const Variable* element;
+      int offset;
+      int count;
+      gamelang::Type index_type;
+    };
+
+    // an operator or array element whose operands compile() is compiling
+    struct Frame {
+      const Binary_operator* binary;  // one of these three is set
+      const Unary_operator* unary;
+      const Variable* element;
+      Opcode op;
+      gamelang::Type common;          // type a binary's operands convert to,
+                                      // an element's own type
+      int stage;                      // operands compiled so far
+      int lhs;                        // register of the lhs (of its truth for AND, OR)
+      int jump;                       // AND, OR: the jump over the rhs
+      bool lhs_is_string_temporary;
+    };
+
+    int compile(const Expression* expr, gamelang::Type& type);
+    int enter(const Expression* expr, gamelang::Type& type, std::vector<Frame>& frames);
+    int resume(Frame& frame, int reg, gamelang::Type& type);
+    static Opcode binary_opcode(const Binary_operator* binary, gamelang::Type& common);
+    static Opcode unary_opcode(const Unary_operator* unary);
+    int compile_node(const Expression* expr, gamelang::Type type);
+    int compile_variable(const Variable* variable, gamelang::Type type,
+                         std::vector<Frame>& frames);
+    int element(const Instruction& load) const;
+    int convert(int reg, gamelang::Type from, gamelang::Type to);
+    int emit(Opcode op, int dst, int a = 0, int b = 0);
+    int new_register(gamelang::Type type);
+
+    std::vector<Instruction> code;
+    std::vector<const Expression*> nodes;
+    std::vector<Array> arrays;
+    std::vector<int> int_registers;
+    std::vector<double> double_registers;
+    std::vector<std::string> string_registers;
+    int result_register;
+    gamelang::Type result_type;
+};
+
+#endif
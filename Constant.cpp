@@ -1,14 +1,14 @@
 //File: Constant.cpp
 #include "Constant.h"
 
-gamelang::Type  Constant::type() const 
-{ return intrinsic_type; }
+void Constant_deleter::operator()(const Constant* constant) const
+{ if (constant && !constant->is_shared()) delete constant; }
 
-const Constant*   Integer_constant::evaluate() const
-{ return new Integer_constant(*this); }
+Constant_ptr      Integer_constant::evaluate() const
+{ return Constant_ptr(is_shared() ? this : new Integer_constant(*this)); }
 
-const Constant*   Double_constant::evaluate() const
-{ return new Double_constant(*this); }
+Constant_ptr      Double_constant::evaluate() const
+{ return Constant_ptr(is_shared() ? this : new Double_constant(*this)); }
 
-const Constant*   String_constant::evaluate() const
-{ return new String_constant(*this); }
+Constant_ptr      String_constant::evaluate() const
+{ return Constant_ptr(is_shared() ? this : new String_constant(*this)); }
@@ -1,54 +1,87 @@
 //File: Constant.h
 #ifndef CONSTANT_H
 #define CONSTANT_H
+#include <cassert>
 #include "Expression.h"
 #include "types_and_ops.h"
+#include "number_format.h"
 
+// A Constant built by the parser is shared: it comes from literals
+// (literal_pool.h) and its evaluate() returns itself.  Any other Constant
+// (a result, or one built by hand) evaluates to a copy of itself.
+//
+// The number is kept in the base class, so the accessors are inline reads
+// that neither make a virtual call nor throw.  Each may only be called for
+// a type() that converts to its type (gamelang::converts_to()), which the
+// caller checks first: as_int() needs an int, as_double() an int or
+// double, as_string() an int, double or string.  Check type() itself, not
+// only the static type of the expression the Constant came from.
 class Constant : public Expression {
   public:
-    Constant(gamelang::Type enum_name) : intrinsic_type(enum_name) {}
-    virtual const Constant*   evaluate() const=0;
-    virtual int         as_int()    const {throw intrinsic_type;}
-    virtual double      as_double() const {throw intrinsic_type;}
-    virtual std::string as_string() const {throw intrinsic_type;}
-    virtual gamelang::Type   type()      const final;
+    virtual Constant_ptr evaluate() const=0;
+    virtual Value       value()     const=0;
+    int as_int() const
+    {
+      assert(type() == gamelang::INT);
+      return int_data;
+    }
+    double as_double() const
+    {
+      assert(gamelang::converts_to(type(), gamelang::DOUBLE));
+      return type() == gamelang::INT ? int_data : double_data;
+    }
+    std::string as_string() const;
   protected:
+    Constant(gamelang::Type type, int d) : Expression(type), int_data(d) {}
+    Constant(gamelang::Type type, double d) : Expression(type), double_data(d) {}
     Constant(const Constant&)=default;
-  private:
-    gamelang::Type intrinsic_type;
+    union {
+      int    int_data;
+      double double_data;
+    };
 };
 
 class Integer_constant : public Constant {
   public:
-    Integer_constant(int d) : Constant(gamelang::INT), data(d) {}
-    virtual int         as_int()    const { return data; }
-    virtual double      as_double() const { return data; }
-    virtual std::string as_string() const { return std::to_string(data);}
-    virtual const Constant*   evaluate() const;
+    Integer_constant(int d) : Constant(gamelang::INT, d) {}
+    virtual Constant_ptr evaluate() const;
+    virtual Value       value()     const { return Value(int_data); }
+    virtual bool        evaluate_bool() const { return int_data != 0; }
   private:
     Integer_constant(const Integer_constant&)=default;
-    int data;
 };
 
 class Double_constant : public Constant {
   public:
-    Double_constant(double d) : Constant(gamelang::DOUBLE), data(d) {}
-    virtual double      as_double() const { return data; }
-    virtual std::string as_string() const { return std::to_string(data);}
-    virtual const Constant*   evaluate() const;
+    Double_constant(double d) : Constant(gamelang::DOUBLE, d) {}
+    virtual Constant_ptr evaluate() const;
+    virtual Value       value()     const { return Value(double_data); }
+    virtual bool        evaluate_bool() const { return double_data != 0.0; }
   private:
     Double_constant(const Double_constant&)=default;
-    double data;
 };
 
 class String_constant : public Constant {
   public:
-    String_constant(const std::string& d) : Constant(gamelang::STRING), data(d) {}
-    virtual std::string as_string() const { return data;}
-    virtual const Constant*   evaluate() const;
+    String_constant(const std::string& d) : Constant(gamelang::STRING, 0), data(d) {}
+    virtual Constant_ptr evaluate() const;
+    virtual Value       value()     const { return Value(data); }
+    virtual std::string_view string_value(std::string&) const { return data; }
   private:
+    friend class Constant;
     String_constant(const String_constant&)=default;
     std::string data;
 };
 
+inline std::string Constant::as_string() const
+{
+  switch (type()) {
+    case gamelang::INT:    return gamelang::number_to_string(int_data);
+    case gamelang::DOUBLE: return gamelang::number_to_string(double_data);
+    default:
+      assert(type() == gamelang::STRING);
+      return static_cast<const String_constant*>(this)->data;
+  }
+}
+
 #endif
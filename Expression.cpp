@@ -1,115 +1,269 @@
 // File: Expression.cpp
 #include "Expression.h"
+#include "Bytecode.h"
 #include "Constant.h"
+#include "literal_pool.h"
 #include "error.h"
 #include "scope_man.h"
+#include "number_format.h"
 #include<string>
+#include <cassert>
 #include <cmath>
+#include <limits>
 #include <numbers>
+#include <vector>
 using std::string;
 
 extern Scope_manager sm;
 
+Expression::~Expression()
+{
+  delete compiled;
+}
+
+Constant_ptr Expression::evaluate() const
+{
+  if (depth() > RECURSION_LIMIT) {
+    if (!compiled)
+      compiled = new Bytecode(this);
+    return compiled->run().as_constant();
+  }
+  return value().as_constant();
+}
+
+void Expression::destroy(const Expression* expr)
+{
+  // the outermost call owns the list of nodes to delete; the destructors
+  // it runs just add their operands to it through pending.  The list is a
+  // local, not a static, so a destroy() from a global's destructor at exit
+  // (~Statement_builder) never finds it already destroyed.
+  static std::vector<const Expression*>* pending = nullptr;
+
+  if (!expr || expr->shared)
+    return;
+  if (pending) {
+    pending->push_back(expr);
+    return;
+  }
+  std::vector<const Expression*> doomed{expr};
+  pending = &doomed;
+  while (!doomed.empty()) {
+    const Expression* expr = doomed.back();
+    doomed.pop_back();
+    delete expr;
+  }
+  pending = nullptr;
+}
+
+std::string_view Expression::string_value(std::string& buffer) const
+{
+  Value v = value();
+  switch (v.type()) {
+    case gamelang::NO_TYPE: buffer.clear(); break;  // already reported
+    case gamelang::INT:    buffer.assign(gamelang::Number_text(v.as_int()).view()); break;
+    case gamelang::DOUBLE: buffer.assign(gamelang::Number_text(v.as_double()).view()); break;
+    default:               buffer = v.as_string(); break;
+  }
+  return buffer;
+}
+
+void Expression::append_string(std::string& out) const
+{
+  std::string buffer;
+  out.append(string_value(buffer));
+}
+
+bool Expression::evaluate_bool() const
+{
+  if (type() != gamelang::INT && type() != gamelang::DOUBLE)
+    return false;
+  Value v = value();
+  switch (v.type()) {
+    case gamelang::INT:    return v.as_int() != 0;
+    case gamelang::DOUBLE: return v.as_double() != 0.0;
+    default:               return false;
+  }
+}
 
-const Constant* Add::evaluate() const
+gamelang::Type promoted_type(const Expression* lhs, const Expression* rhs)
 {
   gamelang::Type lht=lhs->type();
   gamelang::Type rht=rhs->type();
-  std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-  std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
   if(lht==gamelang::STRING || rht==gamelang::STRING)
-    return new String_constant(lhs_constant->as_string() + //<--addition
-                               rhs_constant->as_string());
+    return gamelang::STRING;
   if(lht==gamelang::DOUBLE || rht==gamelang::DOUBLE)
-    return new Double_constant(lhs_constant->as_double() + //<--addition
-                               rhs_constant->as_double());
-  return new Integer_constant(lhs_constant->as_int() +     //<--addition
-                              rhs_constant->as_int());
+    return gamelang::DOUBLE;
+  return gamelang::INT;
 }
 
-gamelang::Type Add::type() const
+gamelang::Type numeric_type(const Expression* lhs, const Expression* rhs)
 {
   gamelang::Type lht=lhs->type();
   gamelang::Type rht=rhs->type();
-  if(lht==gamelang::STRING || rht==gamelang::STRING)
-    return gamelang::STRING;
   if(lht==gamelang::DOUBLE || rht==gamelang::DOUBLE)
     return gamelang::DOUBLE;
-  return gamelang::INT; 
+  return gamelang::INT;
 }
 
-const Constant* Multiply::evaluate() const
+static bool is_numeric(const Expression* expr)
 {
-  std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-  std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
-  if(lhs->type()==gamelang::DOUBLE || rhs->type()==gamelang::DOUBLE)
-    return new Double_constant(lhs_constant->as_double() * //<--multiply
-                               rhs_constant->as_double());
-  return new Integer_constant(lhs_constant->as_int() *     //<--multiply
-                              rhs_constant->as_int());
+  return expr->type() == gamelang::INT || expr->type() == gamelang::DOUBLE;
+}
+
+// true if evaluating the operator over these literal operands reports nothing
+static bool foldable(gamelang::Operator op, const Constant* lhs, const Constant* rhs)
+{
+  switch (op) {
+    case gamelang::PLUS:
+    case gamelang::LESS_THAN:
+    case gamelang::LESS_EQUAL:
+    case gamelang::GREATER_THAN:
+    case gamelang::GREATER_EQUAL:
+    case gamelang::EQUAL:
+    case gamelang::NOT_EQUAL:
+      return true;
+    case gamelang::MINUS:
+    case gamelang::MULTIPLY:
+      return is_numeric(lhs) && is_numeric(rhs);
+    case gamelang::DIVIDE:
+      return is_numeric(lhs) && is_numeric(rhs) && rhs->value().as_double() != 0.0;
+    case gamelang::MOD:
+      return lhs->type() == gamelang::INT && rhs->type() == gamelang::INT
+             && rhs->value().as_int() != 0;
+    case gamelang::AND:
+    case gamelang::OR:
+      return lhs->type() != gamelang::STRING && rhs->type() != gamelang::STRING;
+    default:
+      return false;
+  }
+}
+
+static bool foldable(gamelang::Operator op, const Constant* operand)
+{
+  switch (op) {
+    case gamelang::RANDOM:
+      return false;
+    case gamelang::SQRT:
+      return is_numeric(operand) && operand->value().as_double() >= 0.0;
+    default:
+      return is_numeric(operand);
+  }
+}
+
+const Expression* fold(const Expression* expr)
+{
+  bool literal_operands = false;
+  if (auto binary = dynamic_cast<const Binary_operator*>(expr)) {
+    auto lhs = dynamic_cast<const Constant*>(binary->get_lhs());
+    auto rhs = dynamic_cast<const Constant*>(binary->get_rhs());
+    literal_operands = lhs && rhs && foldable(binary->get_operator(), lhs, rhs);
+  }
+  else if (auto unary = dynamic_cast<const Unary_operator*>(expr)) {
+    auto operand = dynamic_cast<const Constant*>(unary->get_operand());
+    literal_operands = operand && foldable(unary->get_operator(), operand);
+  }
+  if (!literal_operands)
+    return expr;
+
+  Value result = expr->value();
+  if (result.type() != expr->type())
+    return expr;  // not of the node's type; left to be reported where used
+  delete expr;
+  return literals.constant(result);
 }
 
-gamelang::Type Multiply::type() const
+Value Add::value() const
 {
   gamelang::Type lht=lhs->type();
   gamelang::Type rht=rhs->type();
+  if(type()==gamelang::STRING) {
+    std::string result;
+    string_value(result);  // always built in result
+    return Value(std::move(result));
+  }
+  Value lhs_value = lhs->value();
+  Value rhs_value = rhs->value();
+  if(!lhs_value.is_valid() || !rhs_value.is_valid())
+    return Value();  // already reported where the operand failed
   if(lht==gamelang::DOUBLE || rht==gamelang::DOUBLE)
-    return gamelang::DOUBLE;
-  return gamelang::INT;
+    return Value(lhs_value.as_double() + //<--addition
+                 rhs_value.as_double());
+  return Value(lhs_value.as_int() +     //<--addition
+               rhs_value.as_int());
 }
 
-const Constant* Subtract::evaluate() const {
-  gamelang::Type lht = lhs->type();
-  gamelang::Type rht = rhs->type();
-  std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-  std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
-  
-  if (lht == gamelang::DOUBLE || rht == gamelang::DOUBLE) {
-    return new Double_constant(lhs_constant->as_double() - rhs_constant->as_double());
+std::string_view Add::string_value(std::string& buffer) const
+{
+  if(type()!=gamelang::STRING)
+    return Expression::string_value(buffer);
+  buffer.clear();
+  append_string(buffer);
+  return buffer;
+}
+
+void Add::append_string(std::string& out) const
+{
+  if(type()!=gamelang::STRING) {
+    Expression::append_string(out);
+    return;
   }
-  return new Integer_constant(lhs_constant->as_int() - rhs_constant->as_int());
+  lhs->append_string(out);  //<--addition
+  rhs->append_string(out);
 }
 
-gamelang::Type Subtract::type() const {
+Value Multiply::value() const
+{
+  Value lhs_value = lhs->value();
+  Value rhs_value = rhs->value();
+  if(!lhs_value.is_valid() || !rhs_value.is_valid())
+    return Value();
+  if(lhs->type()==gamelang::DOUBLE || rhs->type()==gamelang::DOUBLE)
+    return Value(lhs_value.as_double() * //<--multiply
+                 rhs_value.as_double());
+  return Value(lhs_value.as_int() *     //<--multiply
+               rhs_value.as_int());
+}
+
+Value Subtract::value() const {
   gamelang::Type lht = lhs->type();
   gamelang::Type rht = rhs->type();
+  Value lhs_value = lhs->value();
+  Value rhs_value = rhs->value();
+  if (!lhs_value.is_valid() || !rhs_value.is_valid()) {
+    return Value();
+  }
+  
   if (lht == gamelang::DOUBLE || rht == gamelang::DOUBLE) {
-    return gamelang::DOUBLE;
+    return Value(lhs_value.as_double() - rhs_value.as_double());
   }
-  return gamelang::INT;
+  return Value(lhs_value.as_int() - rhs_value.as_int());
 }
 
-const Constant* Divide::evaluate() const {
-  std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-  std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
+Value Divide::value() const {
+  Value lhs_value = lhs->value();
+  Value rhs_value = rhs->value();
+  if (!lhs_value.is_valid() || !rhs_value.is_valid()) {
+    return Value();
+  }
   
   if (lhs->type() == gamelang::DOUBLE || rhs->type() == gamelang::DOUBLE) {
-      double rhs_val = rhs_constant->as_double();
+      double rhs_val = rhs_value.as_double();
       if (!gamelang::runtime() && rhs_val == 0.0) {
           gamelang::error(gamelang::DIVIDE_BY_ZERO_AT_PARSE_TIME);
-          return new Integer_constant(0);
+          return Value(0.0);  // of the node's type, as Bytecode's DBL_DIV
       }
-      return new Double_constant(lhs_constant->as_double() / rhs_val);
+      return Value(lhs_value.as_double() / rhs_val);
   }
   
-  int rhs_val = rhs_constant->as_int();
+  int rhs_val = rhs_value.as_int();
   if (!gamelang::runtime() && rhs_val == 0) {
       gamelang::error(gamelang::DIVIDE_BY_ZERO_AT_PARSE_TIME);
-      return new Integer_constant(0);
-  }
-  return new Integer_constant(lhs_constant->as_int() / rhs_val);
-}
-
-gamelang::Type Divide::type() const {
-  gamelang::Type lht = lhs->type();
-  gamelang::Type rht = rhs->type();
-  if (lht == gamelang::DOUBLE || rht == gamelang::DOUBLE) {
-      return gamelang::DOUBLE;
+      return Value(0);
   }
-  return gamelang::INT;
+  return Value(lhs_value.as_int() / rhs_val);
 }
 
-const Constant* Mod::evaluate() const {
+Value Mod::value() const {
   bool left_invalid = (lhs->type() != gamelang::INT);
     bool right_invalid = (rhs->type() != gamelang::INT);
     
@@ -120,568 +274,380 @@ const Constant* Mod::evaluate() const {
         if (right_invalid) {
             gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "%");
         }
-        return new Integer_constant(0);
+        return Value(0);
     }
 
-    std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-    std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
+    Value lhs_value = lhs->value();
+    Value rhs_value = rhs->value();
+    if (!lhs_value.is_valid() || !rhs_value.is_valid()) {
+        return Value();
+    }
     
-    int rhs_val = rhs_constant->as_int();
+    int rhs_val = rhs_value.as_int();
     if (!gamelang::runtime() && rhs_val == 0) {
         gamelang::error(gamelang::MOD_BY_ZERO_AT_PARSE_TIME);
-        return new Integer_constant(0);
-    }
-    return new Integer_constant(lhs_constant->as_int() % rhs_val);
-}
-
-gamelang::Type Mod::type() const {
-  return gamelang::INT; 
-}
-
-const Constant* Or::evaluate() const {
-  bool left_invalid = (lhs->type() == gamelang::STRING);
-    bool right_invalid = (rhs->type() == gamelang::STRING);
-    
-    if (left_invalid || right_invalid) {
-        if (left_invalid) {
-            gamelang::error(gamelang::INVALID_LEFT_OPERAND_TYPE, "||");
-        }
-        if (right_invalid) {
-            gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "||");
-        }
-        return new Integer_constant(0);
-    }
-
-    std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-    bool lhs_true = false;
-    
-    switch(lhs->type()) {
-        case gamelang::INT: 
-            lhs_true = (lhs_constant->as_int() != 0); 
-            break;
-        case gamelang::DOUBLE: 
-            lhs_true = (lhs_constant->as_double() != 0.0); 
-            break;
-        default:
-            break; 
-    }
-    
-    if (lhs_true) {
-        return new Integer_constant(1);
-    }
-    
-    std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
-    bool rhs_true = false;
-    switch(rhs->type()) {
-        case gamelang::INT: 
-            rhs_true = (rhs_constant->as_int() != 0); 
-            break;
-        case gamelang::DOUBLE: 
-            rhs_true = (rhs_constant->as_double() != 0.0); 
-            break;
-        default:
-            break; 
+        return Value(0);
     }
-    
-    return new Integer_constant(rhs_true ? 1 : 0);
-}
-
-gamelang::Type Or::type() const {
-  return gamelang::INT;  //returns (0 or 1)
+    return Value(lhs_value.as_int() % rhs_val);
 }
 
-const Constant* And::evaluate() const {
+// And and Or report a string operand on either side, then evaluate the
+// right operand only if the left one doesn't decide the result
+static bool logical_operands_valid(const Expression* lhs, const Expression* rhs,
+                                   const char* op)
+{
   bool left_invalid = (lhs->type() == gamelang::STRING);
   bool right_invalid = (rhs->type() == gamelang::STRING);
-  
-  if (left_invalid || right_invalid) {
-      if (left_invalid) {
-          gamelang::error(gamelang::INVALID_LEFT_OPERAND_TYPE, "&&");
-      }
-      if (right_invalid) {
-          gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "&&");
-      }
-      return new Integer_constant(0);
-  }
-
-  std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-  bool lhs_true = false;
-  
-  switch(lhs->type()) {
-      case gamelang::INT: 
-          lhs_true = (lhs_constant->as_int() != 0); 
-          break;
-      case gamelang::DOUBLE: 
-          lhs_true = (lhs_constant->as_double() != 0.0); 
-          break;
-      default:
-          break; 
+  if (left_invalid) {
+    gamelang::error(gamelang::INVALID_LEFT_OPERAND_TYPE, op);
   }
-  
-  if (!lhs_true) {
-      return new Integer_constant(0);
+  if (right_invalid) {
+    gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, op);
   }
-  
-  std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
-  bool rhs_true = false;
-  switch(rhs->type()) {
-      case gamelang::INT: 
-          rhs_true = (rhs_constant->as_int() != 0); 
-          break;
-      case gamelang::DOUBLE: 
-          rhs_true = (rhs_constant->as_double() != 0.0); 
-          break;
-      default:
-          break; 
-  }
-  
-  return new Integer_constant(rhs_true ? 1 : 0);
+  return !left_invalid && !right_invalid;
 }
 
-gamelang::Type And::type() const {
-  return gamelang::INT;  // returns (0 or 1)
+Value Or::value() const {
+  return Value(evaluate_bool() ? 1 : 0);
 }
 
-const Constant* LessThanOrEqual::evaluate() const {
-  std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-  std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
-  
-  if (lhs->type() == gamelang::STRING || rhs->type() == gamelang::STRING) {
-      std::string lhs_str = lhs_constant->as_string();
-      std::string rhs_str = rhs_constant->as_string();
-      return new Integer_constant(lhs_str <= rhs_str ? 1 : 0);
-  }
-  
-  if (lhs->type() == gamelang::DOUBLE || rhs->type() == gamelang::DOUBLE) {
-      return new Integer_constant(lhs_constant->as_double() <= rhs_constant->as_double() ? 1 : 0);
-  }
-  
-  return new Integer_constant(lhs_constant->as_int() <= rhs_constant->as_int() ? 1 : 0);
-}
-
-gamelang::Type LessThanOrEqual::type() const {
-  return gamelang::INT;  
-}
-
-const Constant* GreaterThanOrEqual::evaluate() const {
-  std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-  std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
-  
-  // string comparisons
-  if (lhs->type() == gamelang::STRING || rhs->type() == gamelang::STRING) {
-      // If both string
-      std::string lhs_str = lhs_constant->as_string();
-      std::string rhs_str = rhs_constant->as_string();
-      return new Integer_constant(lhs_str >= rhs_str ? 1 : 0);
-  }
-  
-  if (lhs->type() == gamelang::DOUBLE || rhs->type() == gamelang::DOUBLE) {
-      return new Integer_constant(lhs_constant->as_double() >= rhs_constant->as_double() ? 1 : 0);
+bool Or::evaluate_bool() const {
+  if (!logical_operands_valid(lhs.get(), rhs.get(), "||")) {
+    return false;
   }
-  
-  return new Integer_constant(lhs_constant->as_int() >= rhs_constant->as_int() ? 1 : 0);
-}
-
-gamelang::Type GreaterThanOrEqual::type() const {
-  return gamelang::INT;  
-}
-
-const Constant* LessThan::evaluate() const {
-  std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-  std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
-  
-  if (lhs->type() == gamelang::STRING || rhs->type() == gamelang::STRING) {
-      std::string lhs_str = lhs_constant->as_string();
-      std::string rhs_str = rhs_constant->as_string();
-      return new Integer_constant(lhs_str < rhs_str ? 1 : 0);
-  }
-  
-  if (lhs->type() == gamelang::DOUBLE || rhs->type() == gamelang::DOUBLE) {
-      return new Integer_constant(lhs_constant->as_double() < rhs_constant->as_double() ? 1 : 0);
-  }
-  
-  return new Integer_constant(lhs_constant->as_int() < rhs_constant->as_int() ? 1 : 0);
+  return lhs->evaluate_bool() || rhs->evaluate_bool();
 }
 
-gamelang::Type LessThan::type() const {
-  return gamelang::INT;
+Value And::value() const {
+  return Value(evaluate_bool() ? 1 : 0);
 }
 
-const Constant* GreaterThan::evaluate() const {
-  std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-  std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
-  
-  if (lhs->type() == gamelang::STRING || rhs->type() == gamelang::STRING) {
-      std::string lhs_str = lhs_constant->as_string();
-      std::string rhs_str = rhs_constant->as_string();
-      return new Integer_constant(lhs_str > rhs_str ? 1 : 0);
-  }
-  
-  if (lhs->type() == gamelang::DOUBLE || rhs->type() == gamelang::DOUBLE) {
-      return new Integer_constant(lhs_constant->as_double() > rhs_constant->as_double() ? 1 : 0);
+bool And::evaluate_bool() const {
+  if (!logical_operands_valid(lhs.get(), rhs.get(), "&&")) {
+    return false;
   }
-  
-  return new Integer_constant(lhs_constant->as_int() > rhs_constant->as_int() ? 1 : 0);
+  return lhs->evaluate_bool() && rhs->evaluate_bool();
 }
 
-gamelang::Type GreaterThan::type() const {
-  return gamelang::INT;
-}
-
-const Constant* Equal::evaluate() const {
-  std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-  std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
-  
-  if (lhs->type() == gamelang::STRING || rhs->type() == gamelang::STRING) {
-      std::string lhs_str = lhs_constant->as_string();
-      std::string rhs_str = rhs_constant->as_string();
-      return new Integer_constant(lhs_str == rhs_str ? 1 : 0);
-  }
-  
-  if (lhs->type() == gamelang::DOUBLE || rhs->type() == gamelang::DOUBLE) {
-      return new Integer_constant(lhs_constant->as_double() == rhs_constant->as_double() ? 1 : 0);
+template <typename Operand>
+static const Expression* comparison(gamelang::Operator op,
+                                    const Expression* lhs, const Expression* rhs)
+{
+  switch (op) {
+    case gamelang::LESS_THAN:
+      return new Comparison<gamelang::LESS_THAN, Operand>(lhs, rhs);
+    case gamelang::LESS_EQUAL:
+      return new Comparison<gamelang::LESS_EQUAL, Operand>(lhs, rhs);
+    case gamelang::GREATER_THAN:
+      return new Comparison<gamelang::GREATER_THAN, Operand>(lhs, rhs);
+    case gamelang::GREATER_EQUAL:
+      return new Comparison<gamelang::GREATER_EQUAL, Operand>(lhs, rhs);
+    case gamelang::EQUAL:
+      return new Comparison<gamelang::EQUAL, Operand>(lhs, rhs);
+    case gamelang::NOT_EQUAL:
+      return new Comparison<gamelang::NOT_EQUAL, Operand>(lhs, rhs);
+    default:
+      assert(false);
+      return nullptr;
   }
-  
-  return new Integer_constant(lhs_constant->as_int() == rhs_constant->as_int() ? 1 : 0);
 }
 
-gamelang::Type Equal::type() const {
-  return gamelang::INT;
-}
-
-const Constant* NotEqual::evaluate() const {
-  std::unique_ptr<const Constant> lhs_constant(lhs->evaluate());
-  std::unique_ptr<const Constant> rhs_constant(rhs->evaluate());
-  
-  if (lhs->type() == gamelang::STRING || rhs->type() == gamelang::STRING) {
-      std::string lhs_str = lhs_constant->as_string();
-      std::string rhs_str = rhs_constant->as_string();
-      return new Integer_constant(lhs_str != rhs_str ? 1 : 0);
-  }
-  
-  if (lhs->type() == gamelang::DOUBLE || rhs->type() == gamelang::DOUBLE) {
-      return new Integer_constant(lhs_constant->as_double() != rhs_constant->as_double() ? 1 : 0);
+const Expression* make_comparison(gamelang::Operator op,
+                                  const Expression* lhs, const Expression* rhs)
+{
+  switch (promoted_type(lhs, rhs)) {
+    case gamelang::STRING: return comparison<std::string>(op, lhs, rhs);
+    case gamelang::DOUBLE: return comparison<double>(op, lhs, rhs);
+    default:               return comparison<int>(op, lhs, rhs);
   }
-  
-  return new Integer_constant(lhs_constant->as_int() != rhs_constant->as_int() ? 1 : 0);
 }
 
-gamelang::Type NotEqual::type() const {
-  return gamelang::INT;
-}
-
-const Constant* Negation::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
+Value Negation::value() const {
+  Value expr_value = expr->value();
+  if (!expr_value.is_valid())
+    return Value();
   
   switch(expr->type()) {
       case gamelang::INT:
-          return new Integer_constant(-expr_constant->as_int());
+          return Value(-expr_value.as_int());
       case gamelang::DOUBLE:
-          return new Double_constant(-expr_constant->as_double());
+          return Value(-expr_value.as_double());
       default:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "-");
-          return new Integer_constant(0);
+          return Value(0);
   }
 }
 
-gamelang::Type Negation::type() const {
-  return expr->type(); 
+Value Not::value() const {
+  return Value(evaluate_bool() ? 1 : 0);
 }
 
-const Constant* Not::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
-  
+bool Not::evaluate_bool() const {
   switch(expr->type()) {
       case gamelang::INT:
-          return new Integer_constant(expr_constant->as_int() == 0 ? 1 : 0);
       case gamelang::DOUBLE:
-          return new Integer_constant(expr_constant->as_double() == 0.0 ? 1 : 0);
+          return !expr->evaluate_bool();
       case gamelang::STRING:
+          expr->value();
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "!", "string");
-          return new Integer_constant(0);
+          return false;
       default:
-          return new Integer_constant(0);
+          expr->value();
+          return false;
   }
 }
 
-gamelang::Type Not::type() const {
-  return gamelang::INT; 
-}
-
-const Constant* Sin::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
-    
-    double radians;
-    switch(expr->type()) {
-        case gamelang::INT:
-            radians = expr_constant->as_int() * (std::numbers::pi / 180.0);
-            return new Double_constant(sin(radians));
-        case gamelang::DOUBLE:
-            radians = expr_constant->as_double() * (std::numbers::pi / 180.0);
-            return new Double_constant(sin(radians));
-        case gamelang::STRING:
-            gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "sin");
-            return nullptr;
-        default:
-            gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "sin");
-            return nullptr;
-    }
-}
-
-gamelang::Type Sin::type() const {
-  return gamelang::DOUBLE;
+Value Sin::value() const {
+  Value expr_value = expr->value();
+  if (!expr_value.is_valid())
+    return Value();
+  
+  double radians;
+  switch(expr->type()) {
+      case gamelang::INT:
+          radians = expr_value.as_int() * (std::numbers::pi / 180.0);
+          return Value(sin(radians));
+      case gamelang::DOUBLE:
+          radians = expr_value.as_double() * (std::numbers::pi / 180.0);
+          return Value(sin(radians));
+      case gamelang::STRING:
+          gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "sin");
+          return Value();
+      default:
+          gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "sin");
+          return Value();
+  }
 }
 
-const Constant* Cos::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
+Value Cos::value() const {
+  Value expr_value = expr->value();
+  if (!expr_value.is_valid())
+    return Value();
   
   switch(expr->type()) {
       case gamelang::INT:
           {
-              double radians = expr_constant->as_int() * (std::numbers::pi / 180.0);
-              return new Double_constant(cos(radians));
+              double radians = expr_value.as_int() * (std::numbers::pi / 180.0);
+              return Value(cos(radians));
           }
       case gamelang::DOUBLE:
           {
-              double radians = expr_constant->as_double() * (std::numbers::pi / 180.0);
-              return new Double_constant(cos(radians));
+              double radians = expr_value.as_double() * (std::numbers::pi / 180.0);
+              return Value(cos(radians));
           }
       case gamelang::STRING:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "cos");
-          return nullptr;
+          return Value();
       default:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "cos");
-          return nullptr;
+          return Value();
   }
 }
 
-gamelang::Type Cos::type() const {
-  return gamelang::DOUBLE;
-}
-
-const Constant* Tan::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
+Value Tan::value() const {
+  Value expr_value = expr->value();
+  if (!expr_value.is_valid())
+    return Value();
   
   switch(expr->type()) {
       case gamelang::INT:
           {
-              double radians = expr_constant->as_int() * (std::numbers::pi / 180.0);
-              return new Double_constant(tan(radians));
+              double radians = expr_value.as_int() * (std::numbers::pi / 180.0);
+              return Value(tan(radians));
           }
       case gamelang::DOUBLE:
           {
-              double radians = expr_constant->as_double() * (std::numbers::pi / 180.0);
-              return new Double_constant(tan(radians));
+              double radians = expr_value.as_double() * (std::numbers::pi / 180.0);
+              return Value(tan(radians));
           }
       case gamelang::STRING:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "tan");
-          return nullptr;
+          return Value();
       default:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "tan");
-          return nullptr;
+          return Value();
   }
 }
 
-gamelang::Type Tan::type() const {
-  return gamelang::DOUBLE;
-}
-
-const Constant* Asin::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
+Value Asin::value() const {
+  Value expr_value = expr->value();
+  if (!expr_value.is_valid())
+    return Value();
 
   switch (expr->type()) {
     case gamelang::INT: {
-      double value = expr_constant->as_int();
+      double value = expr_value.as_int();
       double radians = asin(value); // asin() will return nan if out-of-range
-      return new Double_constant(radians * (180.0 / std::numbers::pi));
+      return Value(radians * (180.0 / std::numbers::pi));
     }
     case gamelang::DOUBLE: {
-      double value = expr_constant->as_double();
+      double value = expr_value.as_double();
       double radians = asin(value); // same here
-      return new Double_constant(radians * (180.0 / std::numbers::pi));
+      return Value(radians * (180.0 / std::numbers::pi));
     }
     case gamelang::STRING:
       gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "asin");
-      return nullptr;
+      return Value();
     default:
       gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "asin");
-      return nullptr;
+      return Value();
   }
 }
 
-gamelang::Type Asin::type() const {
-  return gamelang::DOUBLE;
-}
-
-const Constant* Acos::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
+Value Acos::value() const {
+  Value expr_value = expr->value();
+  if (!expr_value.is_valid())
+    return Value();
 
   switch (expr->type()) {
     case gamelang::INT: {
-      double value = expr_constant->as_int();
+      double value = expr_value.as_int();
       double radians = acos(value);  // will return nan if out of [-1, 1]
-      return new Double_constant(radians * (180.0 / std::numbers::pi));
+      return Value(radians * (180.0 / std::numbers::pi));
     }
     case gamelang::DOUBLE: {
-      double value = expr_constant->as_double();
+      double value = expr_value.as_double();
       double radians = acos(value);  // will return nan if out of [-1, 1]
-      return new Double_constant(radians * (180.0 / std::numbers::pi));
+      return Value(radians * (180.0 / std::numbers::pi));
     }
     case gamelang::STRING:
       gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "acos");
-      return nullptr;
+      return Value();
     default:
       gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "acos");
-      return nullptr;
+      return Value();
   }
 }
 
-gamelang::Type Acos::type() const {
-  return gamelang::DOUBLE;
-}
-
-const Constant* Atan::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
+Value Atan::value() const {
+  Value expr_value = expr->value();
+  if (!expr_value.is_valid())
+    return Value();
   
   switch(expr->type()) {
       case gamelang::INT:
           {
-              double radians = atan(expr_constant->as_int());
-              return new Double_constant(radians * (180.0 / std::numbers::pi)); 
+              double radians = atan(expr_value.as_int());
+              return Value(radians * (180.0 / std::numbers::pi)); 
           }
       case gamelang::DOUBLE:
           {
-              double radians = atan(expr_constant->as_double());
-              return new Double_constant(radians * (180.0 / std::numbers::pi)); 
+              double radians = atan(expr_value.as_double());
+              return Value(radians * (180.0 / std::numbers::pi)); 
           }
       case gamelang::STRING:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "atan");
-          return nullptr;
+          return Value();
       default:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "atan");
-          return nullptr;
+          return Value();
   }
 }
 
-gamelang::Type Atan::type() const {
-  return gamelang::DOUBLE;
-}
-
-const Constant* Sqrt::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
+Value Sqrt::value() const {
+  Value expr_value = expr->value();
+  if (!expr_value.is_valid())
+    return Value();
   
   switch(expr->type()) {
       case gamelang::INT: {
-          int value = expr_constant->as_int();
+          int value = expr_value.as_int();
           if (value < 0) {
               gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "sqrt");
-              return new Double_constant(std::numeric_limits<double>::quiet_NaN());
+              return Value(std::numeric_limits<double>::quiet_NaN());
           }
-          return new Double_constant(sqrt(static_cast<double>(value)));
+          return Value(sqrt(static_cast<double>(value)));
       }
       case gamelang::DOUBLE: {
-          double value = expr_constant->as_double();
+          double value = expr_value.as_double();
           if (value < 0) {
               gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "sqrt");
-              return new Double_constant(std::numeric_limits<double>::quiet_NaN());
+              return Value(std::numeric_limits<double>::quiet_NaN());
           }
-          return new Double_constant(sqrt(value));
+          return Value(sqrt(value));
       }
       case gamelang::STRING:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "sqrt");
-          return nullptr;
+          return Value();
       default:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "sqrt");
-          return nullptr;
+          return Value();
   }
 }
 
-gamelang::Type Sqrt::type() const {
-  return gamelang::DOUBLE;
-}
-
-const Constant* Abs::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
+Value Abs::value() const {
+  Value expr_value = expr->value();
+  if (!expr_value.is_valid())
+    return Value();
   
   switch(expr->type()) {
       case gamelang::INT:
-          return new Integer_constant(abs(expr_constant->as_int()));
+          return Value(abs(expr_value.as_int()));
       case gamelang::DOUBLE:
-          return new Double_constant(fabs(expr_constant->as_double()));
+          return Value(fabs(expr_value.as_double()));
       case gamelang::STRING:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "abs");
-          return nullptr;
+          return Value();
       default:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "abs");
-          return nullptr;
+          return Value();
   }
 }
 
-gamelang::Type Abs::type() const {
-  return expr->type(); 
-}
-
-const Constant* Floor::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
+// floor() has static type int; a double whose floor is no int (a NaN, an
+// infinity, or out of range) is reported and gives 0, as in Bytecode
+Value Floor::value() const {
+  Value expr_value = expr->value();
+  if (!expr_value.is_valid())
+    return Value();
 
   switch(expr->type()) {
     case gamelang::INT:
-      return new Integer_constant(expr_constant->as_int());
+      return Value(expr_value.as_int());
 
     case gamelang::DOUBLE: {
-      double result = floor(expr_constant->as_double());
+      double result = floor(expr_value.as_double());
 
-      if (result == floor(result)) {
-        return new Integer_constant(static_cast<int>(result));
-      } else {
-        return new Double_constant(result);
+      if (!(result >= std::numeric_limits<int>::min()
+            && result <= std::numeric_limits<int>::max())) {
+        gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "floor");
+        return Value(0);
       }
+      return Value(static_cast<int>(result));
     }
 
     case gamelang::STRING:
       gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "floor");
-      return new Integer_constant(0);  
+      return Value(0);  
 
     default:
       gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "floor");
-      return new Integer_constant(0);
-  }
-}
-
-gamelang::Type Floor::type() const {
-  std::unique_ptr<const Constant> val(expr->evaluate());
-  // if type is int
-  if (expr->type() == gamelang::INT) {
-    return gamelang::INT;
-  }
-  double floored = floor(val->as_double());
-  if (floored == static_cast<int>(floored)) {
-    return gamelang::INT;
-  } else {
-    return gamelang::DOUBLE;
+      return Value(0);
   }
 }
 
-const Constant* Random::evaluate() const {
-  std::unique_ptr<const Constant> expr_constant(expr->evaluate());
+Value Random::value() const {
+  Value expr_value = expr->value();
+  if (!expr_value.is_valid())
+    return Value();
   double value;
   std::string value_str;
 
   switch (expr->type()) {
       case gamelang::INT:
-          value = expr_constant->as_int();
+          value = expr_value.as_int();
           value_str = std::to_string(static_cast<int>(value)); // integer string
           break;
       case gamelang::DOUBLE:
-          value = expr_constant->as_double();
+          value = expr_value.as_double();
           value_str = std::to_string(value); // double string
           break;
       case gamelang::STRING:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "random");
-          return new Integer_constant(0);
+          return Value(0);
       default:
           gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "random");
-          return new Integer_constant(0);
+          return Value(0);
   }
 
   if (value < 2) {
@@ -690,69 +656,122 @@ const Constant* Random::evaluate() const {
   }
 
   int result = rand() % static_cast<int>(floor(value));
-  return new Integer_constant(result);
+  return Value(result);
 }
 
-gamelang::Type Random::type() const {
-  return gamelang::INT; // always an int
+static const Symbol* bind(int symbol_id)
+{
+  return sm.lookup(symbol_id);
 }
 
+Variable::Variable(int symbol_id)
+  : Variable(symbol_id, bind(symbol_id), nullptr) {}
+
+Variable::Variable(int symbol_id, const Expression* index_expr)
+  : Variable(symbol_id, bind(symbol_id), index_expr) {}
 
-const Constant* Variable::evaluate() const {
+Variable::Variable(int symbol_id, const Symbol* symbol,
+                   const Expression* index_expr)
+  : Expression(symbol ? symbol->get_type() : gamelang::INT,
+               index_expr ? 1 + index_expr->depth() : 1),
+    symbol_id(symbol_id), symbol(symbol), array_index_expression(index_expr) {}
+
+int Variable::element() const {
+  if (index_proven()) {
+    return array_index_expression->value().as_int();
+  }
+
+  const std::string& symbol_name = get_symbol_name();
   if (symbol_name.empty()) {
-    return new Integer_constant(0); // fallback
+    return -1;
   }
 
-  Symbol* symbol = sm.lookup(symbol_name);
   if (!symbol) {
     std::string display_name = symbol_name;
     if (array_index_expression) {
         display_name += "[]";
     }
     gamelang::error(gamelang::UNDECLARED_VARIABLE, display_name);
-    return new Integer_constant(0); // fallback
+    return -1;
   }
 
   if (!array_index_expression) {
-    return symbol->as_constant();  // scalar access
+    return 0;  // scalar access
   }
 
   // If the symbol is not an array, emit a semantic error
   if (symbol->get_count() == 1) {
     gamelang::error(gamelang::VARIABLE_NOT_AN_ARRAY, symbol_name);
-    return new Integer_constant(0); // fallback
+    return -1;
   }
 
-  std::unique_ptr<const Constant> index_const(array_index_expression->evaluate());
-  if (!index_const) {
+  return element(array_index_expression->value());
+}
+
+Value Variable::value() const {
+  int index = element();
+  if (index < 0) {
+    return Value(0); // fallback
+  }
+  if (!array_index_expression) {
+    return symbol->as_value();  // scalar access
+  }
+  return symbol->as_value(index);
+}
+
+int Variable::element(const Value& index_value) const {
+  const std::string& symbol_name = get_symbol_name();
+  // a bad index at run time uses element 0, as the error says
+  int fallback = gamelang::runtime() ? 0 : -1;
+
+  if (!index_value.is_valid()) {
     gamelang::error(gamelang::ARRAY_INDEX_MUST_BE_AN_INTEGER, symbol_name,
-                    gamelang::to_string(index_const->type()));
-    return new Integer_constant(0); // fallback
+                    gamelang::to_string(index_value.type()));
+    return fallback;
   }
 
-  if (index_const->type() != gamelang::INT) {
+  if (index_value.type() != gamelang::INT) {
     gamelang::error(gamelang::ARRAY_INDEX_MUST_BE_AN_INTEGER, symbol_name, 
-                    gamelang::to_string(index_const->type()));
-    return new Integer_constant(0); // fallback
+                    gamelang::to_string(index_value.type()));
+    return fallback;
   }
 
-  int index = index_const->as_int();
+  int index = index_value.as_int();
   if (index < 0 || index >= symbol->get_count()) {
     gamelang::error(gamelang::ARRAY_INDEX_OUT_OF_BOUNDS, symbol_name, std::to_string(index) );
-    return new Integer_constant(0); // fallback
+    return fallback;
   }
 
-  return symbol->as_constant(index);
+  return index;
 }
 
-gamelang::Type Variable::type() const {
-  if (symbol_name.empty()) {
-      return gamelang::INT;
+bool Variable::evaluate_bool() const {
+  // a string or a whole array has no slot to test; leave it to the
+  // general case
+  if (type() == gamelang::STRING
+      || (symbol && !array_index_expression && symbol->get_count() != 1)) {
+    return Expression::evaluate_bool();
   }
+  int index = element();
+  if (index < 0) {
+    return false;  // value()'s fallback is 0
+  }
+  if (type() == gamelang::INT) {
+    return symbol->int_values()[index] != 0;
+  }
+  return symbol->double_values()[index] != 0.0;
+}
 
-  Symbol* symbol = sm.lookup(symbol_name);
-  if (!symbol) {
-    return gamelang::INT; 
+std::string_view Variable::string_value(std::string& buffer) const {
+  // a whole array has no string value; value() says so
+  if (type() != gamelang::STRING
+      || (symbol && !array_index_expression && symbol->get_count() != 1)) {
+    return Expression::string_value(buffer);
+  }
+  int index = element();
+  if (index < 0) {
+    buffer = Value(0).as_string(); // fallback, as in value()
+    return buffer;
   }
-  return symbol->get_type();
-}
\ No newline at end of file
+  return symbol->string_values()[index];
+}
@@ -1,234 +1,341 @@
 //File: Expression.h
 #ifndef EXPRESSION_H
 #define EXPRESSION_H
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include "types_and_ops.h"
+#include "Value.h"
+#include "intern_pool.h"
+#include "arena.h"
+class Bytecode;
 class Constant;
+class Literal_pool;
+class Symbol;
 class Expression {
   public:
-    Expression() = default;
-    virtual const Constant* evaluate() const=0;
-    virtual gamelang::Type type() const=0;
-    virtual ~Expression() = default;
+    // nodes are allocated from ast_arena (arena.h)
+    ARENA_ALLOCATED
+    // every node is given its static type when it is built, so type() is
+    // a field read and never recurses into (or evaluates) the operands
+    Expression(gamelang::Type type) : static_type(type), tree_depth(1) {}
+    // evaluate() returns the result as a Constant: a new one the
+    // Constant_ptr owns, or a shared one from literals (a literal node
+    // returns itself, a small int result comes from the pool).  It is an
+    // adapter over value(), which returns the result without allocating.
+    // value() recurses once per level of the tree, so a tree deeper than
+    // RECURSION_LIMIT is evaluated through a Bytecode instead, which
+    // runs it with explicit stacks.  It is compiled on the first call and
+    // kept with the tree.
+    virtual Constant_ptr evaluate() const;
+    virtual Value value() const=0;
+    // evaluate_bool() is the expression's truth value, for conditions:
+    // non-zero for an int or double, false for anything else.  Comparison
+    // and logical nodes override it to produce the bool directly, without
+    // building a Value for their own result, and variables and literals to
+    // test the int or double they hold.
+    virtual bool evaluate_bool() const;
+    // string_value() is value().as_string() without the copies: nodes that
+    // already hold the string (a String_constant, a string variable)
+    // return a view of it, anything else formats its value into buffer and
+    // returns a view of that.  The view is valid while buffer and the node
+    // are, and until the variable is next assigned.
+    virtual std::string_view string_value(std::string& buffer) const;
+    // append_string() appends the string value to out.  A chain of string
+    // additions appends each piece to the one result instead of building
+    // every intermediate string, so a + b + c + ... is linear.
+    virtual void append_string(std::string& out) const;
+    gamelang::Type type() const { return static_type; }
+    // levels in the tree below and including this node, set when it is
+    // built (a chain a + b + c + ... of n terms is n deep)
+    int depth() const { return tree_depth; }
+    static constexpr int RECURSION_LIMIT = 1000;
+    // a shared node (a Constant in literals) belongs to the pool; it may
+    // sit in any number of trees and none of them deletes it
+    bool is_shared() const { return shared; }
+    // destroy() deletes expr and everything below it, leaving shared nodes
+    // alone.  It runs from a loop over an explicit list instead of through
+    // nested destructor calls, so any depth of tree can be deleted; the
+    // destructors hand it their operands.  Use it, not delete, for a tree
+    // that may hold literals.
+    static void destroy(const Expression* expr);
+    virtual ~Expression();
     Expression& operator=(const Expression&) = delete;
   protected:
-    Expression(const Expression&) = default;
+    Expression(gamelang::Type type, int depth) : static_type(type), tree_depth(depth) {}
+    // a copy (of a Constant) is not shared and has no Bytecode of its own
+    Expression(const Expression& other)
+      : static_type(other.static_type), tree_depth(other.tree_depth) {}
+  private:
+    friend class Literal_pool;
+    gamelang::Type static_type;
+    int tree_depth;
+    bool shared = false;
+    // evaluate() of a deep tree, deleted with the node (a raw pointer so
+    // the inline constructors don't need Bytecode to be complete)
+    mutable Bytecode* compiled = nullptr;
 };
 
+// static result types shared by the operator constructors
+//   promoted_type: string if either operand is a string, else double if
+//                  either is a double, else int (the type of +)
+//   numeric_type:  double if either operand is a double, else int
+gamelang::Type promoted_type(const Expression* lhs, const Expression* rhs);
+gamelang::Type numeric_type(const Expression* lhs, const Expression* rhs);
+
 class Variable : public Expression {
   public:
-    Variable(const std::string& symbol_name)
-      : symbol_name(symbol_name), array_index_expression(nullptr) {}
-
-    Variable(const std::string& symbol_name, const Expression* index_expr)
-      : symbol_name(symbol_name), array_index_expression(index_expr) {}
+    // a Variable is bound to the symbol in scope when the parser builds it
+    // and takes its type (int if there is none; value() then reports the
+    // undeclared variable).  symbol_id is the name's id in identifiers
+    // (intern_pool.h); the name itself is only needed for diagnostics.
+    Variable(int symbol_id);
+    Variable(int symbol_id, const Expression* index_expr);
 
-    virtual const Constant* evaluate() const override;
-    virtual gamelang::Type type() const override;
-    virtual ~Variable() = default;
+    virtual Value value() const override;
+    virtual bool evaluate_bool() const override;
+    virtual std::string_view string_value(std::string& buffer) const override;
+    virtual ~Variable() { destroy(array_index_expression.release()); }
 
     Variable(const Variable&) = delete;
     Variable& operator=(const Variable&) = delete;
-    const std::string& get_symbol_name() const { return symbol_name; }
+    const std::string& get_symbol_name() const {
+      return identifiers.name(symbol_id);
+    }
+    const Symbol* get_symbol() const { return symbol; }
     bool is_whole_array_reference() const {
       return array_index_expression == nullptr;
     }
+    const Expression* get_index_expression() const {
+      return array_index_expression.get();
+    }
+    // *proof is set by the loop analysis (loop_bounds.h) once it has shown
+    // the index is an int within the array whenever this node is evaluated;
+    // element() then skips its checks
+    void set_index_proof(const bool* proof) { index_proof = proof; }
+    bool index_proven() const { return index_proof && *index_proof; }
+    // the element referred to (0 for a scalar), or -1 once the reason
+    // there isn't one has been reported; at run time a bad index is
+    // reported and gives element 0.  Assignments store through it
+    int element() const;
+    // element() of an array element whose index the caller evaluated
+    // itself (a Bytecode), to index
+    int element(const Value& index) const;
 
   protected:
-    std::string symbol_name;
+    Variable(int symbol_id, const Symbol* symbol, const Expression* index_expr);
+    int symbol_id;
+    const Symbol* symbol;
     std::unique_ptr<const Expression> array_index_expression;
+    const bool* index_proof = nullptr;
 };
 
 class Binary_operator : public Expression {
   public:
-    Binary_operator(const Expression* lhs, const Expression* rhs) :lhs(lhs), rhs(rhs) {}
-    virtual const Constant* evaluate() const=0;
+    Binary_operator(const Expression* lhs, const Expression* rhs,
+                    gamelang::Operator op, gamelang::Type type)
+      : Expression(type, 1 + std::max(lhs->depth(), rhs->depth())),
+        lhs(lhs), rhs(rhs), op(op) {}
+    virtual ~Binary_operator() {
+      destroy(lhs.release());
+      destroy(rhs.release());
+    }
+    gamelang::Operator get_operator() const { return op; }
+    const Expression* get_lhs() const { return lhs.get(); }
+    const Expression* get_rhs() const { return rhs.get(); }
   protected:
     std::unique_ptr<const Expression> lhs;
     std::unique_ptr<const Expression> rhs;
+    gamelang::Operator op;
 };
 
 class Subtract : public Binary_operator {
   public:
-    Subtract(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-    virtual const Constant* evaluate() const;
-    virtual gamelang::Type type() const;
+    Subtract(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs, gamelang::MINUS, numeric_type(lhs, rhs)){};
+    virtual Value value() const;
 };
 
 class Add : public Binary_operator {
   public:
-    Add(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-    virtual const Constant* evaluate() const;
-    virtual gamelang::Type type() const;
+    Add(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs, gamelang::PLUS, promoted_type(lhs, rhs)){};
+    virtual Value value() const;
+    virtual std::string_view string_value(std::string& buffer) const override;
+    virtual void append_string(std::string& out) const override;
 };
 
 class Multiply : public Binary_operator {
   public:
-    Multiply(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-    virtual const Constant* evaluate() const;
-    virtual gamelang::Type type() const;
+    Multiply(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs, gamelang::MULTIPLY, numeric_type(lhs, rhs)){};
+    virtual Value value() const;
 };
 
 class Divide : public Binary_operator {
   public:
-      Divide(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-      virtual const Constant* evaluate() const override;
-      virtual gamelang::Type type() const override;
+      Divide(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs, gamelang::DIVIDE, numeric_type(lhs, rhs)){};
+      virtual Value value() const override;
   };
 
 class Mod : public Binary_operator {
   public:
-      Mod(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-      virtual const Constant* evaluate() const override;
-      virtual gamelang::Type type() const override;
+      Mod(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs, gamelang::MOD, gamelang::INT){};
+      virtual Value value() const override;
   };
 
 class Or : public Binary_operator {
   public:
-      Or(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-      virtual const Constant* evaluate() const override;
-      virtual gamelang::Type type() const override;
+      Or(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs, gamelang::OR, gamelang::INT){};
+      virtual Value value() const override;
+      virtual bool evaluate_bool() const override;
   };
 
 class And : public Binary_operator {
   public:
-    And(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-    virtual const Constant* evaluate() const override;
-    virtual gamelang::Type type() const override;
+    And(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs, gamelang::AND, gamelang::INT){};
+    virtual Value value() const override;
+    virtual bool evaluate_bool() const override;
   };
 
-  class LessThanOrEqual : public Binary_operator {
-    public:
-        LessThanOrEqual(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
-    };
-
-  class GreaterThanOrEqual : public Binary_operator {
-    public:
-        GreaterThanOrEqual(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
-    };
-  
-
-  class LessThan : public Binary_operator {
+  // Comparison<OP, Operand> compares two operands as Operand (int, double
+  // or std::string) without looking at their types: the parser picks the
+  // instantiation from the operands' static types (make_comparison), so
+  // an int < int node is a straight int compare.  The result is 0 or 1.
+  template <gamelang::Operator OP, typename Operand>
+  class Comparison : public Binary_operator {
     public:
-        LessThan(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
-    };
-      
-  class GreaterThan : public Binary_operator {
-    public:
-        GreaterThan(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
-    };
-
-  class Equal : public Binary_operator {
-    public:
-        Equal(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
-    };
-      
-  class NotEqual : public Binary_operator {
-    public:
-        NotEqual(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs){};
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
+        Comparison(const Expression* lhs, const Expression* rhs) : Binary_operator(lhs, rhs, OP, gamelang::INT){};
+        virtual Value value() const override {
+          return Value(evaluate_bool() ? 1 : 0);
+        }
+        virtual bool evaluate_bool() const override {
+          if constexpr (std::is_same_v<Operand, std::string>) {
+            std::string lhs_buffer;
+            std::string rhs_buffer;
+            std::string_view l = lhs->string_value(lhs_buffer);
+            std::string_view r = rhs->string_value(rhs_buffer);
+            return compare(l, r);
+          }
+          else {
+            Value l = lhs->value();
+            Value r = rhs->value();
+            if (!l.is_valid() || !r.is_valid())
+              return false;  // already reported
+            return compare(operand(l), operand(r));
+          }
+        }
+    private:
+        static Operand operand(const Value& v) {
+          if constexpr (std::is_same_v<Operand, int>) return v.as_int();
+          else return v.as_double();
+        }
+        template <typename T>
+        static bool compare(const T& l, const T& r) {
+          if constexpr (OP == gamelang::LESS_THAN) return l < r;
+          else if constexpr (OP == gamelang::LESS_EQUAL) return l <= r;
+          else if constexpr (OP == gamelang::GREATER_THAN) return l > r;
+          else if constexpr (OP == gamelang::GREATER_EQUAL) return l >= r;
+          else if constexpr (OP == gamelang::EQUAL) return l == r;
+          else return l != r;
+        }
     };
 
   class Unary_operator : public Expression {
+    public:
+        gamelang::Operator get_operator() const { return op; }
+        const Expression* get_operand() const { return expr; }
     protected:
         const Expression* expr;
-        Unary_operator(const Expression* expr) : expr(expr) {}
-        virtual ~Unary_operator() { delete expr; }
+        gamelang::Operator op;
+        Unary_operator(const Expression* expr, gamelang::Operator op, gamelang::Type type)
+          : Expression(type, 1 + expr->depth()), expr(expr), op(op) {}
+        virtual ~Unary_operator() { destroy(expr); }
     };
 
   class Negation : public Unary_operator {
     public:
-        Negation(const Expression* expr) : Unary_operator(expr) {}
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
+        Negation(const Expression* expr) : Unary_operator(expr, gamelang::UNARY_MINUS, expr->type()) {}
+        virtual Value value() const override;
     };
 
   class Not : public Unary_operator {
     public:
-        Not(const Expression* expr) : Unary_operator(expr) {}
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
+        Not(const Expression* expr) : Unary_operator(expr, gamelang::NOT, gamelang::INT) {}
+        virtual Value value() const override;
+        virtual bool evaluate_bool() const override;
     };
   
   class Sin : public Unary_operator {
     public:
-        Sin(const Expression* expr) : Unary_operator(expr) {}
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
+        Sin(const Expression* expr) : Unary_operator(expr, gamelang::SIN, gamelang::DOUBLE) {}
+        virtual Value value() const override;
     };
 
   class Cos : public Unary_operator {
     public:
-        Cos(const Expression* expr) : Unary_operator(expr) {}
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
+        Cos(const Expression* expr) : Unary_operator(expr, gamelang::COS, gamelang::DOUBLE) {}
+        virtual Value value() const override;
     };
       
   class Tan : public Unary_operator {
     public:
-      Tan(const Expression* expr) : Unary_operator(expr) {}
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
+      Tan(const Expression* expr) : Unary_operator(expr, gamelang::TAN, gamelang::DOUBLE) {}
+        virtual Value value() const override;
     };
 
   class Asin : public Unary_operator {
     public:
-        Asin(const Expression* expr) : Unary_operator(expr) {}
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
+        Asin(const Expression* expr) : Unary_operator(expr, gamelang::ASIN, gamelang::DOUBLE) {}
+        virtual Value value() const override;
     };
       
   class Acos : public Unary_operator {
     public:
-        Acos(const Expression* expr) : Unary_operator(expr) {}
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
+        Acos(const Expression* expr) : Unary_operator(expr, gamelang::ACOS, gamelang::DOUBLE) {}
+        virtual Value value() const override;
     };
       
   class Atan : public Unary_operator {
     public:
-        Atan(const Expression* expr) : Unary_operator(expr) {}
-        virtual const Constant* evaluate() const override;
-        virtual gamelang::Type type() const override;
+        Atan(const Expression* expr) : Unary_operator(expr, gamelang::ATAN, gamelang::DOUBLE) {}
+        virtual Value value() const override;
     };
 
   class Sqrt : public Unary_operator {
       public:
-        Sqrt(const Expression* expr) : Unary_operator(expr) {}
-        const Constant* evaluate() const override;
-        gamelang::Type type() const override;
+        Sqrt(const Expression* expr) : Unary_operator(expr, gamelang::SQRT, gamelang::DOUBLE) {}
+        Value value() const override;
   };
 
   class Abs : public Unary_operator {
     public:
-        Abs(const Expression* expr) : Unary_operator(expr) {}
-        const Constant* evaluate() const override;
-        gamelang::Type type() const override;
+        Abs(const Expression* expr) : Unary_operator(expr, gamelang::ABS, expr->type()) {}
+        Value value() const override;
   };
 
   class Floor : public Unary_operator {
     public:
-        Floor(const Expression* expr) : Unary_operator(expr) {}
-        const Constant* evaluate() const override;
-        gamelang::Type type() const override;
+        Floor(const Expression* expr) : Unary_operator(expr, gamelang::FLOOR, gamelang::INT) {}
+        Value value() const override;
   };
 
   class Random : public Unary_operator {
     public:
-        Random(const Expression* expr) : Unary_operator(expr) {}
-        const Constant* evaluate() const override;
-        gamelang::Type type() const override;
+        Random(const Expression* expr) : Unary_operator(expr, gamelang::RANDOM, gamelang::INT) {}
+        Value value() const override;
   };
 
+// make_comparison() builds the Comparison for op (one of the six relational
+// operators) specialized for the operands' static types: strings if
+// either is a string, else doubles if either is a double, else ints.
+const Expression* make_comparison(gamelang::Operator op,
+                                  const Expression* lhs, const Expression* rhs);
+
+// fold() replaces an operator whose operands are all literals with a single
+// Constant holding its value and deletes the operator.  Anything else is
+// returned unchanged, including operators whose evaluation would report an
+// error (division by zero, bad operand types, ...) so those diagnostics
+// are still produced when and where they were before, and random().
+const Expression* fold(const Expression* expr);
+
 #endif
@@ -0,0 +1,30 @@
+//File: Value.cpp
+#include "Value.h"
+#include "Constant.h"
+#include "literal_pool.h"
+#include "number_format.h"
+
+std::string Value::as_string() const
+{
+  switch (value_type) {
+    case gamelang::STRING: return string_data;
+    case gamelang::DOUBLE: return gamelang::number_to_string(double_data);
+    case gamelang::INT:    return gamelang::number_to_string(int_data);
+    default:
+      assert(value_type == gamelang::STRING);
+      return std::string();
+  }
+}
+
+Constant_ptr Value::as_constant() const
+{
+  switch (value_type) {
+    case gamelang::INT:
+      if (const Constant* pooled = literals.small_integer(int_data))
+        return Constant_ptr(pooled);
+      return Constant_ptr(new Integer_constant(int_data));
+    case gamelang::DOUBLE: return Constant_ptr(new Double_constant(double_data));
+    case gamelang::STRING: return Constant_ptr(new String_constant(string_data));
+    default:               return nullptr;
+  }
+}
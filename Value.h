@@ -0,0 +1,70 @@
+//File: Value.h
+#ifndef VALUE_H
+#define VALUE_H
+#include <cassert>
+#include <memory>
+#include <string>
+#include <utility>
+#include "types_and_ops.h"
+
+class Constant;
+
+// Constant_ptr holds the Constant an evaluate() returns.  It deletes the
+// Constant unless it is shared (a pooled literal, literal_pool.h), which it
+// only points at.
+struct Constant_deleter {
+  void operator()(const Constant* constant) const;
+};
+using Constant_ptr = std::unique_ptr<const Constant, Constant_deleter>;
+
+// A Value is the result of Expression::value(): a small tagged int, double
+// or string returned by value.  Numbers are stored inline and never touch
+// the heap; short strings stay in std::string's inline buffer.
+//
+// A default constructed Value has type NO_TYPE.  It is returned by an
+// expression whose evaluation already reported an error (the cases where
+// evaluate() used to return nullptr).
+class Value {
+  public:
+    Value() : value_type(gamelang::NO_TYPE), int_data(0) {}
+    Value(int d) : value_type(gamelang::INT), int_data(d) {}
+    Value(double d) : value_type(gamelang::DOUBLE), double_data(d) {}
+    Value(const std::string& d)
+      : value_type(gamelang::STRING), int_data(0), string_data(d) {}
+    Value(std::string&& d)
+      : value_type(gamelang::STRING), int_data(0), string_data(std::move(d)) {}
+
+    gamelang::Type type() const { return value_type; }
+    bool is_valid() const { return value_type != gamelang::NO_TYPE; }
+
+    // same conversions as the Constant accessors: an int can be read as a
+    // double, a valid Value as a string.  The caller checks is_valid() (and
+    // the type) first; past the assert, a Value of the wrong type reads as
+    // 0, 0.0 or "" instead of throwing.
+    int as_int() const
+    {
+      assert(value_type == gamelang::INT);
+      return value_type == gamelang::INT ? int_data : 0;
+    }
+    double as_double() const
+    {
+      assert(gamelang::converts_to(value_type, gamelang::DOUBLE));
+      if (value_type == gamelang::DOUBLE) return double_data;
+      return value_type == gamelang::INT ? int_data : 0.0;
+    }
+    std::string as_string() const;
+
+    // adapter for the Constant interface: a new Constant (the pooled one
+    // for a small int), or nullptr if this Value is not valid
+    Constant_ptr as_constant() const;
+
+  private:
+    gamelang::Type value_type;
+    union {
+      int    int_data;
+      double double_data;
+    };
+    std::string string_data;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "arena.h"
+#include <new>
+
+void* Arena::allocate(size_t size) {
+    size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    nodes++;
+    live_nodes++;
+    bytes += size;
+    if (size > MAX_BLOCK) {
+        return ::operator new(size);
+    }
+
+    Free_block*& free_list = free_lists[size / ALIGNMENT];
+    if (free_list) {
+        Free_block* block = free_list;
+        free_list = block->next;
+        return block;
+    }
+
+    if (static_cast<size_t>(end - next) < size) {
+        chunks.push_back(std::make_unique_for_overwrite<char[]>(CHUNK_SIZE));
+        next = chunks.back().get();
+        end = next + CHUNK_SIZE;
+    }
+    void* block = next;
+    next += size;
+    return block;
+}
+
+void Arena::deallocate(void* block, size_t size) {
+    if (!block) {
+        return;
+    }
+    size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    live_nodes--;
+    if (size > MAX_BLOCK) {
+        ::operator delete(block);
+        return;
+    }
+    Free_block*& free_list = free_lists[size / ALIGNMENT];
+    free_list = new (block) Free_block{free_list};
+}
+
+Arena::Stats Arena::stats() const {
+    return Stats{nodes, live_nodes, bytes, chunks.size() * CHUNK_SIZE,
+                 chunks.size()};
+}
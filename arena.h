@@ -0,0 +1,76 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Arena hands out memory for the objects the parser builds (Expression
+// nodes and Symbols) by bumping a pointer through large chunks, so the
+// nodes of a tree sit next to each other.  The chunks are only released
+// when the arena is destroyed.
+//
+// Deleting an object still runs its destructor.  Its block goes on a free
+// list for its size and is handed out again, so the temporary Constants
+// built while a program runs do not grow the arena.
+//
+// Objects are deleted one at a time even when the program ends, rather
+// than dropped with their chunks: a String_constant's text and the
+// Bytecode an Expression caches for evaluate() live outside the arena,
+// and only the destructors free them.  The chunks themselves are released
+// together.
+//
+// Classes opt in by declaring an operator new/delete that forward to
+// ast_arena (see ARENA_ALLOCATED below).
+class Arena {
+public:
+    Arena() = default;
+    ~Arena() = default;
+
+    void* allocate(size_t size);
+    void deallocate(void* block, size_t size);
+
+    struct Stats {
+        size_t nodes;        // every allocate()
+        size_t live_nodes;   // allocate() minus deallocate()
+        size_t bytes;        // handed out, rounded up to ALIGNMENT
+        size_t chunk_bytes;  // reserved in chunks
+        size_t chunks;
+    };
+    Stats stats() const;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+private:
+    static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+    // blocks larger than this come from (and go back to) ::operator new
+    static constexpr size_t MAX_BLOCK = 512;
+
+    struct Free_block {
+        Free_block* next;
+    };
+
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char* next = nullptr;
+    char* end = nullptr;
+    Free_block* free_lists[MAX_BLOCK / ALIGNMENT + 1] = {};
+    size_t nodes = 0;
+    size_t live_nodes = 0;
+    size_t bytes = 0;
+};
+
+// Defined in gpl.y before literals, sm and statement_builder, so it is
+// destroyed after every Constant, Symbol and Expression they own.
+extern Arena ast_arena;
+
+#define ARENA_ALLOCATED                                                \
+    static void* operator new(size_t size) {                           \
+        return ast_arena.allocate(size);                               \
+    }                                                                  \
+    static void operator delete(void* block, size_t size) {            \
+        ast_arena.deallocate(block, size);                             \
+    }
+
+#endif
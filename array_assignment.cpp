@@ -0,0 +1,302 @@
+#include "array_assignment.h"
+#include "Expression.h"
+#include "Constant.h"
+#include "error.h"
+#include "math_kernels.h"
+#include "symbol.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// With g++ and clang++ the element loops below work on vectors of lanes
+// (+ - * and ?: are defined on them), one SSE register's worth of ints or
+// doubles per step, so they run SIMD even without -O.  Registers are CHUNK
+// elements long, so a step may run past the last element of a short final
+// chunk into lanes nobody reads.
+#ifdef __GNUC__
+typedef int Int_lanes __attribute__((vector_size(16)));
+typedef double Double_lanes __attribute__((vector_size(16)));
+typedef int Int_pair __attribute__((vector_size(8)));
+
+template <typename T> struct Lanes_of;
+template <> struct Lanes_of<int> { typedef Int_lanes type; };
+template <> struct Lanes_of<double> { typedef Double_lanes type; };
+
+// out[i] = f(a[i], b[i]) for i < n
+template <typename T, typename F>
+void each(T* out, const T* a, const T* b, int n, F f)
+{
+  typedef typename Lanes_of<T>::type V;
+  const int lanes = sizeof(V) / sizeof(T);
+  for (int i = 0; i < n; i += lanes) {
+    V x, y;
+    std::memcpy(&x, a + i, sizeof x);
+    std::memcpy(&y, b + i, sizeof y);
+    V z = f(x, y);
+    std::memcpy(out + i, &z, sizeof z);
+  }
+}
+
+void int_to_double(double* out, const int* in, int n)
+{
+  for (int i = 0; i < n; i += 2) {
+    Int_pair x;
+    std::memcpy(&x, in + i, sizeof x);
+    Double_lanes z = __builtin_convertvector(x, Double_lanes);
+    std::memcpy(out + i, &z, sizeof z);
+  }
+}
+#else
+template <typename T, typename F>
+void each(T* out, const T* a, const T* b, int n, F f)
+{
+  for (int i = 0; i < n; i++)
+    out[i] = f(a[i], b[i]);
+}
+
+void int_to_double(double* out, const int* in, int n)
+{
+  for (int i = 0; i < n; i++)
+    out[i] = in[i];
+}
+#endif
+
+}
+
+Array_assignment::Array_assignment(const Symbol* target)
+  : target(target), result_register(0), result_type(gamelang::INT) {}
+
+std::unique_ptr<Array_assignment> Array_assignment::compile(const Symbol* target,
+                                                            const Expression* expr)
+{
+  if (!target || target->get_count() <= 1)
+    return nullptr;
+  gamelang::Type target_type = target->get_type();
+  if (target_type != gamelang::INT && target_type != gamelang::DOUBLE)
+    return nullptr;
+  // compile() recurses; a tree this deep is left to the Bytecode path
+  if (expr->depth() > Expression::RECURSION_LIMIT)
+    return nullptr;
+
+  std::unique_ptr<Array_assignment> assignment(new Array_assignment(target));
+  gamelang::Type type;
+  int result = assignment->compile(expr, type);
+  if (result < 0 || (target_type == gamelang::INT && type != gamelang::INT))
+    return nullptr;
+  if (target_type == gamelang::DOUBLE && type == gamelang::INT) {
+    int converted = assignment->new_register(gamelang::DOUBLE);
+    assignment->emit(INT_TO_DBL, converted, result);
+    result = converted;
+    type = gamelang::DOUBLE;
+  }
+  assignment->result_register = result;
+  assignment->result_type = type;
+  assignment->int_registers.shrink_to_fit();
+  assignment->double_registers.shrink_to_fit();
+  return assignment;
+}
+
+int Array_assignment::emit(Opcode op, int dst, int a, int b)
+{
+  code.push_back(Instruction{op, dst, a, b});
+  return dst;
+}
+
+int Array_assignment::new_register(gamelang::Type type)
+{
+  if (type == gamelang::INT) {
+    int_registers.resize(int_registers.size() + CHUNK);
+    return int_registers.size() / CHUNK - 1;
+  }
+  double_registers.resize(double_registers.size() + CHUNK);
+  return double_registers.size() / CHUNK - 1;
+}
+
+// the register holding expr's elements, or -1 if expr is not element-wise
+int Array_assignment::compile(const Expression* expr, gamelang::Type& type)
+{
+  type = expr->type();
+  if (type != gamelang::INT && type != gamelang::DOUBLE)
+    return -1;
+
+  if (dynamic_cast<const Constant*>(expr)) {
+    int dst = new_register(type);
+    scalars.push_back(Scalar{expr, dst, type});
+    return dst;
+  }
+
+  if (auto variable = dynamic_cast<const Variable*>(expr)) {
+    const Symbol* symbol = variable->get_symbol();
+    if (!symbol || !variable->is_whole_array_reference())
+      return -1;
+    if (symbol->get_count() == 1) {
+      int dst = new_register(type);
+      scalars.push_back(Scalar{expr, dst, type});
+      return dst;
+    }
+    if (symbol->get_count() != target->get_count())
+      return -1;
+    arrays.push_back(symbol);
+    return emit(type == gamelang::INT ? LOAD_INTS : LOAD_DOUBLES,
+                new_register(type), arrays.size() - 1);
+  }
+
+  if (auto binary = dynamic_cast<const Binary_operator*>(expr)) {
+    bool is_int = type == gamelang::INT;
+    Opcode op;
+    switch (binary->get_operator()) {
+      case gamelang::PLUS:     op = is_int ? INT_ADD : DBL_ADD; break;
+      case gamelang::MINUS:    op = is_int ? INT_SUB : DBL_SUB; break;
+      case gamelang::MULTIPLY: op = is_int ? INT_MUL : DBL_MUL; break;
+      case gamelang::DIVIDE:
+        // an int division by zero has to be caught element by element
+        if (is_int)
+          return -1;
+        op = DBL_DIV;
+        break;
+      default:
+        return -1;
+    }
+    gamelang::Type lht, rht;
+    int l = compile(binary->get_lhs(), lht);
+    int r = l < 0 ? -1 : compile(binary->get_rhs(), rht);
+    if (r < 0)
+      return -1;
+    if (!is_int && lht == gamelang::INT)
+      l = emit(INT_TO_DBL, new_register(gamelang::DOUBLE), l);
+    if (!is_int && rht == gamelang::INT)
+      r = emit(INT_TO_DBL, new_register(gamelang::DOUBLE), r);
+    return emit(op, new_register(type), l, r);
+  }
+
+  if (auto unary = dynamic_cast<const Unary_operator*>(expr)) {
+    gamelang::Operator op = unary->get_operator();
+    if (op != gamelang::UNARY_MINUS && op != gamelang::ABS && op != gamelang::FLOOR
+        && op != gamelang::SQRT && !gamelang::has_math_kernel(op))
+      return -1;
+    gamelang::Type operand_type;
+    int operand = compile(unary->get_operand(), operand_type);
+    if (operand < 0)
+      return -1;
+    bool is_int = operand_type == gamelang::INT;
+    switch (op) {
+      case gamelang::UNARY_MINUS:
+        return emit(is_int ? INT_NEG : DBL_NEG, new_register(type), operand);
+      case gamelang::ABS:
+        return emit(is_int ? INT_ABS : DBL_ABS, new_register(type), operand);
+      case gamelang::FLOOR:
+        // floor() of a double may be a NaN, which has no int to store
+        return is_int ? operand : -1;
+      default:
+        break;
+    }
+    if (is_int)
+      operand = emit(INT_TO_DBL, new_register(gamelang::DOUBLE), operand);
+    if (op == gamelang::SQRT)
+      return emit(DBL_SQRT, new_register(gamelang::DOUBLE), operand);
+    return emit(DBL_MATH, new_register(gamelang::DOUBLE), operand, op);
+  }
+
+  return -1;
+}
+
+void Array_assignment::execute()
+{
+  // a scalar does not change while the assignment runs, so its register
+  // is filled once.  One that has no value (its error is already
+  // reported) leaves the array as it was, like a failed Bytecode.
+  for (const Scalar& scalar : scalars) {
+    Value v = scalar.node->value();
+    if (!v.is_valid())
+      return;
+    if (scalar.type == gamelang::INT)
+      std::fill_n(ints(scalar.dst), CHUNK, v.as_int());
+    else
+      std::fill_n(doubles(scalar.dst), CHUNK, v.as_double());
+  }
+
+  int count = target->get_count();
+  for (int base = 0; base < count; base += CHUNK) {
+    int n = std::min(CHUNK, count - base);
+    for (const Instruction& in : code) {
+      switch (in.op) {
+        case LOAD_INTS:
+          std::copy_n(arrays[in.a]->int_values() + base, n, ints(in.dst));
+          break;
+        case LOAD_DOUBLES:
+          std::copy_n(arrays[in.a]->double_values() + base, n, doubles(in.dst));
+          break;
+
+        case INT_ADD:
+          each(ints(in.dst), ints(in.a), ints(in.b), n, [](auto x, auto y) { return x + y; });
+          break;
+        case INT_SUB:
+          each(ints(in.dst), ints(in.a), ints(in.b), n, [](auto x, auto y) { return x - y; });
+          break;
+        case INT_MUL:
+          each(ints(in.dst), ints(in.a), ints(in.b), n, [](auto x, auto y) { return x * y; });
+          break;
+        case INT_NEG:
+          each(ints(in.dst), ints(in.a), ints(in.a), n, [](auto x, auto) { return -x; });
+          break;
+        case INT_ABS:
+          each(ints(in.dst), ints(in.a), ints(in.a), n,
+               [](auto x, auto) { return x < 0 ? -x : x; });
+          break;
+        case INT_TO_DBL:
+          int_to_double(doubles(in.dst), ints(in.a), n);
+          break;
+
+        case DBL_ADD:
+          each(doubles(in.dst), doubles(in.a), doubles(in.b), n, [](auto x, auto y) { return x + y; });
+          break;
+        case DBL_SUB:
+          each(doubles(in.dst), doubles(in.a), doubles(in.b), n, [](auto x, auto y) { return x - y; });
+          break;
+        case DBL_MUL:
+          each(doubles(in.dst), doubles(in.a), doubles(in.b), n, [](auto x, auto y) { return x * y; });
+          break;
+        case DBL_DIV:
+          each(doubles(in.dst), doubles(in.a), doubles(in.b), n, [](auto x, auto y) { return x / y; });
+          break;
+        case DBL_NEG:
+          each(doubles(in.dst), doubles(in.a), doubles(in.a), n, [](auto x, auto) { return -x; });
+          break;
+        case DBL_ABS: {
+          // fabs, not x < 0 ? -x : x, so that abs(-0.0) is 0
+          const double* a = doubles(in.a);
+          double* dst = doubles(in.dst);
+          for (int i = 0; i < n; i++)
+            dst[i] = std::fabs(a[i]);
+          break;
+        }
+        case DBL_SQRT: {
+          const double* a = doubles(in.a);
+          double* dst = doubles(in.dst);
+          for (int i = 0; i < n; i++) {
+            // reported for each element, as Sqrt::value() would
+            if (a[i] < 0) {
+              gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "sqrt");
+              dst[i] = std::numeric_limits<double>::quiet_NaN();
+            } else {
+              dst[i] = std::sqrt(a[i]);
+            }
+          }
+          break;
+        }
+        case DBL_MATH:
+          gamelang::apply_math(static_cast<gamelang::Operator>(in.b),
+                               doubles(in.a), doubles(in.dst), n);
+          break;
+      }
+    }
+
+    if (result_type == gamelang::INT)
+      std::copy_n(ints(result_register), n, target->int_values() + base);
+    else
+      std::copy_n(doubles(result_register), n, target->double_values() + base);
+  }
+}
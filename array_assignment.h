@@ -0,0 +1,88 @@
+#ifndef ARRAY_ASSIGNMENT_H
+#define ARRAY_ASSIGNMENT_H
+
+#include <memory>
+#include <vector>
+#include "types_and_ops.h"
+
+class Expression;
+class Symbol;
+
+// An Array_assignment is an assignment to a whole int or double array,
+//     x = x + vx;      (int x[1000]; int vx[1000];)
+// whose expression is element-wise: it applies + - * / (double division
+// only), unary minus, abs, sqrt or a trigonometric builtin to whole arrays
+// of the target's size, scalar variables and constants.  Element i of the
+// target becomes the expression with every whole array replaced by its
+// element i.
+//
+// This is the opt-in array-expression mode: an assignment statement whose
+// target is a whole array (rejected with VARIABLE_IS_AN_ARRAY otherwise)
+// asks compile() for one.  execute() then runs the expression over the
+// contiguous elements in symbol_storage, a chunk of the arrays at a time,
+// with SIMD loops (gamelang::apply_math() for sin, cos, ...) instead of a
+// scripted for loop evaluating a Variable, with its bounds check, for
+// every element.  Scalar variables are read once per execute().
+//
+// The expression tree must outlive its Array_assignment.
+class Array_assignment {
+  public:
+    // nullptr if target is not an int or double array or expr is not
+    // element-wise over arrays of its size (an int division, an indexed
+    // element, random(), a double assigned to an int array, ...); the
+    // caller then reports or runs the assignment the ordinary way
+    static std::unique_ptr<Array_assignment> compile(const Symbol* target,
+                                                     const Expression* expr);
+
+    void execute();
+    int size() const { return code.size(); }
+
+    Array_assignment(const Array_assignment&) = delete;
+    Array_assignment& operator=(const Array_assignment&) = delete;
+
+  private:
+    // elements evaluated per pass; a multiple of every lane count
+    static constexpr int CHUNK = 256;
+
+    enum Opcode : unsigned char {
+      LOAD_INTS, LOAD_DOUBLES,
+      INT_ADD, INT_SUB, INT_MUL, INT_NEG, INT_ABS, INT_TO_DBL,
+      DBL_ADD, DBL_SUB, DBL_MUL, DBL_DIV, DBL_NEG, DBL_ABS, DBL_SQRT,
+      DBL_MATH
+    };
+
+    // dst, a and b are registers (a CHUNK of ints or doubles, as selected
+    // by the opcode); a LOAD_* keeps its array in a, a DBL_MATH its
+    // gamelang::Operator in b
+    struct Instruction {
+      Opcode op;
+      int dst;
+      int a;
+      int b;
+    };
+
+    // a scalar operand: node's value fills register dst once per execute()
+    struct Scalar {
+      const Expression* node;
+      int dst;
+      gamelang::Type type;
+    };
+
+    explicit Array_assignment(const Symbol* target);
+    int compile(const Expression* expr, gamelang::Type& type);
+    int emit(Opcode op, int dst, int a = 0, int b = 0);
+    int new_register(gamelang::Type type);
+    int* ints(int reg) { return int_registers.data() + reg * CHUNK; }
+    double* doubles(int reg) { return double_registers.data() + reg * CHUNK; }
+
+    const Symbol* target;
+    std::vector<Instruction> code;
+    std::vector<Scalar> scalars;
+    std::vector<const Symbol*> arrays;
+    std::vector<int> int_registers;
+    std::vector<double> double_registers;
+    int result_register;
+    gamelang::Type result_type;
+};
+
+#endif
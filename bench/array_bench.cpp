@@ -0,0 +1,124 @@
+// File: bench/array_bench.cpp
+// Whole-array assignments against the scripted loop they replace,
+//     for (i = 0; i < n; i += 1) x[i] = x[i] + vx[i];
+// tree-walking x[i] + vx[i] (two bounds checks) for every element and
+// storing the result, against one Array_assignment::execute() of x = x + vx.
+#include "bench.h"
+#include "array_assignment.h"
+#include "Constant.h"
+#include "intern_pool.h"
+#include "scope_man.h"
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+extern Scope_manager sm;
+
+static double checksum = 0;  // keeps the timed loops from being optimized away
+
+static int declare_array(const std::string& name, gamelang::Type type, int count)
+{
+  int id = identifiers.intern(name);
+  Symbol* symbol = new Symbol(id, type, count);
+  sm.add_to_current_scope(symbol);
+  for (int i = 0; i < count; i++) {
+    if (type == gamelang::INT)
+      symbol->int_values()[i] = i % 7 - 3;
+    else
+      symbol->double_values()[i] = i * 0.25;
+  }
+  return id;
+}
+
+// target = element(i) for every i, through the tree, against
+// target = whole through an Array_assignment
+static void run(const char* name, int target, const Expression* element,
+                const Expression* whole, int rounds)
+{
+  std::unique_ptr<const Expression> element_tree(element);
+  std::unique_ptr<const Expression> whole_tree(whole);
+  Symbol* symbol = sm.lookup(target);
+  Symbol* index = sm.lookup(identifiers.intern("i"));
+  int count = symbol->get_count();
+  bool is_int = symbol->get_type() == gamelang::INT;
+
+  std::unique_ptr<Array_assignment> assignment =
+    Array_assignment::compile(symbol, whole_tree.get());
+  if (!assignment) {
+    std::printf("%-28s NOT ELEMENT-WISE\n", name);
+    return;
+  }
+
+  Symbol_storage::Snapshot start = symbol_storage.snapshot();
+  Stopwatch loop_clock;
+  for (int round = 0; round < rounds; round++) {
+    for (int i = 0; i < count; i++) {
+      index->int_values()[0] = i;
+      Value v = element_tree->value();
+      if (is_int)
+        symbol->int_values()[i] = v.as_int();
+      else
+        symbol->double_values()[i] = v.as_double();
+    }
+  }
+  double loop_ms = loop_clock.elapsed_ms();
+  Symbol_storage::Snapshot looped = symbol_storage.snapshot();
+
+  symbol_storage.restore(start);
+  Stopwatch array_clock;
+  for (int round = 0; round < rounds; round++)
+    assignment->execute();
+  double array_ms = array_clock.elapsed_ms();
+
+  // the kernels may differ from libm in the last bits, nothing more
+  double difference = 0;
+  for (int i = 0; i < count; i++) {
+    int element = symbol->get_offset() + i;
+    difference = is_int
+      ? std::max(difference, std::fabs(double(symbol->int_values()[i] - looped.ints[element])))
+      : std::max(difference, std::fabs(symbol->double_values()[i] - looped.doubles[element]));
+    checksum += is_int ? symbol->int_values()[i] : symbol->double_values()[i];
+  }
+
+  double per_element = 1e6 / (double(rounds) * count);
+  std::printf("%-28s loop %6.2f ns  array %5.2f ns per element  (%.0fx)  "
+              "largest difference %g\n",
+              name, loop_ms * per_element, array_ms * per_element,
+              loop_ms / array_ms, difference);
+}
+
+static Variable* element(int array)
+{
+  return new Variable(array, new Variable(identifiers.intern("i")));
+}
+
+int main()
+{
+  sm.add_to_current_scope(new Symbol(identifiers.intern("i"), 0));
+  sm.add_to_current_scope(new Symbol(identifiers.intern("radius"), 40.0));
+
+  for (int count : {1000, 100000}) {
+    std::string n = std::to_string(count);
+    int x = declare_array("x" + n, gamelang::INT, count);
+    int vx = declare_array("vx" + n, gamelang::INT, count);
+    int angle = declare_array("angle" + n, gamelang::DOUBLE, count);
+    int px = declare_array("px" + n, gamelang::DOUBLE, count);
+    int rounds = 20000000 / count;
+    std::printf("%d elements\n", count);
+
+    // x = x + vx
+    run("  x = x + vx", x,
+        new Add(element(x), element(vx)),
+        new Add(new Variable(x), new Variable(vx)),
+        rounds);
+
+    // px = px + radius * cos(angle)
+    int radius = identifiers.intern("radius");
+    run("  px = px + radius*cos(angle)", px,
+        new Add(element(px), new Multiply(new Variable(radius), new Cos(element(angle)))),
+        new Add(new Variable(px), new Multiply(new Variable(radius), new Cos(new Variable(angle)))),
+        rounds / 4);
+  }
+  std::printf("(checksum %g)\n", checksum);
+}
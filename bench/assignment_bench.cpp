@@ -0,0 +1,148 @@
+// File: bench/assignment_bench.cpp
+// The in-place assignments of a Statement_block against the naive ones
+// they replace, which evaluate the target as a Constant, build the new
+// value and look the symbol up again to store it:
+//     for (i = 0; i < 1000000; i++) { n += 3; n -= i % 4; d += 0.5; }
+//     for (i = 0; i < 20000; i++) { s += "x"; }
+// The string loop is shorter because the naive += copies the whole string
+// every time.
+#include "bench.h"
+#include "Constant.h"
+#include "intern_pool.h"
+#include "scope_man.h"
+#include "statement_block.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+
+extern Scope_manager sm;
+
+static long checksum = 0;  // keeps the timed loops from being optimized away
+
+const int NUMBER_ITERATIONS = 1000000;
+const int STRING_ITERATIONS = 20000;
+const int RUNS = 5;
+
+// target op= value, the naive way
+struct Naive_assign : Statement {
+  Naive_assign(int id, Assignment_form::Kind kind, const Expression* value)
+    : id(id), kind(kind), target(new Variable(id)), value(value) {}
+  void execute() const override {
+    Constant_ptr old = target->evaluate();
+    Value v = value ? value->value() : Value(1);
+    Symbol* symbol = sm.lookup(id);
+    switch (symbol->get_type()) {
+      case gamelang::INT: {
+        int result = kind == Assignment_form::ASSIGN ? v.as_int()
+                   : kind == Assignment_form::MINUS_ASSIGN ? old->as_int() - v.as_int()
+                   : old->as_int() + v.as_int();
+        symbol->int_values()[0] = result;
+        break;
+      }
+      case gamelang::DOUBLE:
+        symbol->double_values()[0] = kind == Assignment_form::ASSIGN ? v.as_double()
+                                   : old->as_double() + v.as_double();
+        break;
+      default:
+        symbol->string_values()[0] = old->as_string() + v.as_string();
+        break;
+    }
+  }
+  int id;
+  Assignment_form::Kind kind;
+  std::unique_ptr<const Variable> target;
+  std::unique_ptr<const Expression> value;
+};
+
+static bool parse()
+{
+  std::string program = "int i;\n"
+                        "int n;\n"
+                        "double d;\n"
+                        "string s;\n"
+                        "initialization {\n"
+                        "  for (i = 0; i < " + std::to_string(NUMBER_ITERATIONS) + "; i++) {\n"
+                        "    n += 3;\n"
+                        "    n -= i % 4;\n"
+                        "    d += 0.5;\n"
+                        "  }\n"
+                        "}\n"
+                        "termination {\n"
+                        "  for (i = 0; i < " + std::to_string(STRING_ITERATIONS) + "; i++) {\n"
+                        "    s += \"x\";\n"
+                        "  }\n"
+                        "}\n";
+  return parse_program(program, "gpl_assignment_bench.gpl")
+         && statement_builder.blocks().size() == 2;
+}
+
+static For* naive_loop(int i, int iterations)
+{
+  For* loop = new For;
+  loop->init.reset(new Naive_assign(i, Assignment_form::ASSIGN, new Integer_constant(0)));
+  loop->condition.reset(make_comparison(gamelang::LESS_THAN, new Variable(i),
+                                        new Integer_constant(iterations)));
+  loop->update.reset(new Naive_assign(i, Assignment_form::PLUS_PLUS, nullptr));
+  loop->body.reset(new Block);
+  return loop;
+}
+
+// the fastest of RUNS runs of each, after reset() before every run
+template <typename Reset, typename Result>
+static void compare(const char* name, const Statement* naive, const Statement_block* block,
+                    Reset reset, Result result)
+{
+  double naive_ms = 0, block_ms = 0;
+  for (int run = 0; run < RUNS; run++) {
+    reset();
+    Stopwatch naive_clock;
+    naive->execute();
+    double ms = naive_clock.elapsed_ms();
+    naive_ms = run == 0 || ms < naive_ms ? ms : naive_ms;
+    checksum += result();
+
+    reset();
+    Stopwatch block_clock;
+    block->execute();
+    ms = block_clock.elapsed_ms();
+    block_ms = run == 0 || ms < block_ms ? ms : block_ms;
+    checksum += result();
+  }
+  std::printf("%-32s naive %8.2f ms  in place %8.2f ms  (%.2fx)  result %ld\n",
+              name, naive_ms, block_ms, naive_ms / block_ms, long(result()));
+}
+
+int main()
+{
+  if (!parse()) {
+    std::printf("parse failed\n");
+    return 1;
+  }
+  const int i = identifiers.intern("i");
+  const int n = identifiers.intern("n");
+  const int d = identifiers.intern("d");
+  const int s = identifiers.intern("s");
+  Symbol* n_symbol = sm.lookup(n);
+  Symbol* d_symbol = sm.lookup(d);
+  Symbol* s_symbol = sm.lookup(s);
+
+  std::unique_ptr<For> numbers(naive_loop(i, NUMBER_ITERATIONS));
+  numbers->body->statements.emplace_back(
+    new Naive_assign(n, Assignment_form::PLUS_ASSIGN, new Integer_constant(3)));
+  numbers->body->statements.emplace_back(
+    new Naive_assign(n, Assignment_form::MINUS_ASSIGN,
+                     new Mod(new Variable(i), new Integer_constant(4))));
+  numbers->body->statements.emplace_back(
+    new Naive_assign(d, Assignment_form::PLUS_ASSIGN, new Double_constant(0.5)));
+  compare("n += 3; n -= i % 4; d += 0.5;", numbers.get(), statement_builder.blocks()[0].get(),
+          [&] { n_symbol->int_values()[0] = 0; d_symbol->double_values()[0] = 0; },
+          [&] { return n_symbol->int_values()[0] + long(d_symbol->double_values()[0]); });
+
+  std::unique_ptr<For> strings(naive_loop(i, STRING_ITERATIONS));
+  strings->body->statements.emplace_back(
+    new Naive_assign(s, Assignment_form::PLUS_ASSIGN, new String_constant("x")));
+  compare("s += \"x\";", strings.get(), statement_builder.blocks()[1].get(),
+          [&] { s_symbol->string_values()[0].clear(); },
+          [&] { return long(s_symbol->string_values()[0].size()); });
+  return checksum == 0;
+}
@@ -0,0 +1,82 @@
+// File: bench/bench.h
+// Helpers shared by the benchmark programs in bench/ (make bench).
+//
+// Each benchmark is linked with every gpl object except gpl.o, so it
+// provides the yyerror() that gpl.cpp normally supplies to the parser.
+#ifndef BENCH_H
+#define BENCH_H
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "error.h"
+#include "Expression.h"
+
+extern FILE *yyin;
+extern int yyparse();
+int yylex_destroy();
+
+int yyerror(const char *str)
+{
+  gamelang::error(gamelang::PARSE_ERROR, str);
+  return 1;
+}
+
+class Stopwatch {
+  public:
+    Stopwatch() : start(std::chrono::steady_clock::now()) {}
+    double elapsed_ms() const
+    {
+      std::chrono::duration<double, std::milli> d =
+        std::chrono::steady_clock::now() - start;
+      return d.count();
+    }
+  private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// parses program as gpl would, from a file (a temporary one, named name);
+// true if it parsed
+inline bool parse_program(const std::string& program, const char* name)
+{
+  std::string path = (std::filesystem::temp_directory_path() / name).string();
+  std::ofstream(path) << program;
+  yyin = std::fopen(path.c_str(), "r");
+  int result = yyparse();
+  std::fclose(yyin);
+  yyin = nullptr;
+  yylex_destroy();
+  std::filesystem::remove(path);
+  return result == 0;
+}
+
+// A statement tree walked through virtual calls, the form a Statement_block
+// (statement_block.h) replaces; benchmarks build one by hand to compare.
+struct Statement {
+  virtual ~Statement() = default;
+  virtual void execute() const = 0;
+};
+
+struct Block : Statement {
+  void execute() const override {
+    for (const auto& statement : statements)
+      statement->execute();
+  }
+  std::vector<std::unique_ptr<Statement>> statements;
+};
+
+struct For : Statement {
+  void execute() const override {
+    for (init->execute(); condition->evaluate_bool(); update->execute())
+      body->execute();
+  }
+  std::unique_ptr<Statement> init;
+  std::unique_ptr<const Expression> condition;
+  std::unique_ptr<Statement> update;
+  std::unique_ptr<Block> body;
+};
+
+#endif
@@ -0,0 +1,81 @@
+// File: bench/bounds_bench.cpp
+// The body of
+//     for (i = 0; i < 1000; i += 1) ... a[i] + b[i + 1] ...
+// evaluated for every i, as built outside a loop (every element checks its
+// index) and as the parser builds it inside this loop, where Loop_bounds
+// proves both indexes in range and the checks are skipped.
+#include "bench.h"
+#include "Constant.h"
+#include "intern_pool.h"
+#include "loop_bounds.h"
+#include "scope_man.h"
+#include <cstdio>
+#include <memory>
+
+extern Scope_manager sm;
+
+static long checksum = 0;  // keeps the timed loops from being optimized away
+
+const int COUNT = 1000;
+
+// a[i] + b[i + 1], reporting each element to the analysis as the parser does
+static const Expression* body(int a, int b, int i)
+{
+  Variable* a_i = new Variable(a, new Variable(i));
+  loop_bounds.indexed(a_i);
+  Variable* b_i = new Variable(b, new Add(new Variable(i), new Integer_constant(1)));
+  loop_bounds.indexed(b_i);
+  return new Add(a_i, b_i);
+}
+
+static double run(const Expression* expr, Symbol* index, int rounds)
+{
+  std::unique_ptr<const Expression> tree(expr);
+  Stopwatch clock;
+  for (int round = 0; round < rounds; round++) {
+    for (int i = 0; i < COUNT; i++) {
+      index->int_values()[0] = i;
+      checksum += tree->value().as_int();
+    }
+  }
+  return clock.elapsed_ms() * 1e6 / (double(rounds) * COUNT);
+}
+
+int main()
+{
+  const int i = identifiers.intern("i");
+  const int a = identifiers.intern("a");
+  const int b = identifiers.intern("b");
+  sm.add_to_current_scope(new Symbol(i, 0));
+  sm.add_to_current_scope(new Symbol(a, gamelang::INT, COUNT));
+  sm.add_to_current_scope(new Symbol(b, gamelang::INT, COUNT + 1));
+  Symbol* index = sm.lookup(i);
+  const int rounds = 10000;
+
+  const Expression* checked = body(a, b, i);
+
+  Variable* init_target = new Variable(i);
+  Variable* update_target = new Variable(i);
+  const Expression* start = new Integer_constant(0);
+  const Expression* step = new Integer_constant(1);
+  const Expression* condition = make_comparison(gamelang::LESS_THAN, new Variable(i),
+                                                new Integer_constant(COUNT));
+  loop_bounds.enter_loop(Assignment_form{Assignment_form::ASSIGN, init_target, start},
+                         condition,
+                         Assignment_form{Assignment_form::PLUS_ASSIGN, update_target, step});
+  const Expression* unchecked = body(a, b, i);
+  loop_bounds.leave_loop();
+
+  std::printf("unchecked elements %d of 2\n", loop_bounds.unchecked_elements());
+  double checked_ns = run(checked, index, rounds);
+  double unchecked_ns = run(unchecked, index, rounds);
+  std::printf("a[i] + b[i + 1]  checked %6.1f ns  unchecked %6.1f ns  (%.2fx)\n",
+              checked_ns, unchecked_ns, checked_ns / unchecked_ns);
+
+  delete init_target;
+  delete update_target;
+  delete start;
+  delete step;
+  delete condition;
+  return checksum == 0;
+}
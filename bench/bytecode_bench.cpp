@@ -0,0 +1,95 @@
+// File: bench/bytecode_bench.cpp
+// Tree walking (Expression::value) against the compiled form (Bytecode::run)
+// for a few typical animation-block expressions.  Each pair of results is
+// checked for equality before it is timed.
+#include "bench.h"
+#include "Bytecode.h"
+#include "Constant.h"
+#include "intern_pool.h"
+#include "scope_man.h"
+#include <cstdio>
+#include <memory>
+
+extern Scope_manager sm;
+
+static long checksum = 0;  // keeps the timed loops from being optimized away
+
+static bool same(const Value& a, const Value& b)
+{
+  if (a.type() != b.type())
+    return false;
+  switch (a.type()) {
+    case gamelang::INT:    return a.as_int() == b.as_int();
+    case gamelang::DOUBLE: return a.as_double() == b.as_double();
+    default:               return a.as_string() == b.as_string();
+  }
+}
+
+static void run(const char* name, const Expression* expr, int rounds)
+{
+  std::unique_ptr<const Expression> tree(expr);
+  Bytecode bytecode(tree.get());
+  if (!same(tree->value(), bytecode.run())) {
+    std::printf("%-12s MISMATCH: %s vs %s\n", name,
+                tree->value().as_string().c_str(),
+                bytecode.run().as_string().c_str());
+    return;
+  }
+
+  Stopwatch tree_clock;
+  for (int i = 0; i < rounds; i++)
+    checksum += tree->value().type();
+  double tree_ms = tree_clock.elapsed_ms();
+
+  Stopwatch bytecode_clock;
+  for (int i = 0; i < rounds; i++)
+    checksum -= bytecode.run().type();
+  double bytecode_ms = bytecode_clock.elapsed_ms();
+
+  std::printf("%-12s %3d instructions  tree %8.1f ns  bytecode %8.1f ns  (%.1fx)\n",
+              name, bytecode.size(), tree_ms * 1e6 / rounds,
+              bytecode_ms * 1e6 / rounds, tree_ms / bytecode_ms);
+}
+
+int main()
+{
+  const int x = identifiers.intern("x");
+  const int angle = identifiers.intern("angle");
+  const int name = identifiers.intern("name");
+  sm.add_to_current_scope(new Symbol(x, 7));
+  sm.add_to_current_scope(new Symbol(angle, 30.0));
+  sm.add_to_current_scope(new Symbol(name, std::string("player")));
+  const int rounds = 200000;
+
+  // x * 2 + 3 - x / 2 % 5
+  run("int arith",
+      new Subtract(new Add(new Multiply(new Variable(x), new Integer_constant(2)),
+                           new Integer_constant(3)),
+                   new Mod(new Divide(new Variable(x), new Integer_constant(2)),
+                           new Integer_constant(5))),
+      rounds);
+
+  // 100 + 40 * cos(angle) * 1.5 - sin(angle * 2)
+  run("trig",
+      new Subtract(new Add(new Integer_constant(100),
+                           new Multiply(new Multiply(new Integer_constant(40),
+                                                     new Cos(new Variable(angle))),
+                                        new Double_constant(1.5))),
+                   new Sin(new Multiply(new Variable(angle), new Integer_constant(2)))),
+      rounds);
+
+  // x < 10 && angle >= 0.5 || !(x == 3)
+  run("condition",
+      new Or(new And(make_comparison(gamelang::LESS_THAN, new Variable(x), new Integer_constant(10)),
+                     make_comparison(gamelang::GREATER_EQUAL, new Variable(angle),
+                                     new Double_constant(0.5))),
+             new Not(make_comparison(gamelang::EQUAL, new Variable(x), new Integer_constant(3)))),
+      rounds);
+
+  // name + ": " + x * 10
+  run("string",
+      new Add(new Add(new Variable(name), new String_constant(": ")),
+              new Multiply(new Variable(x), new Integer_constant(10))),
+      rounds);
+  return checksum != 0;
+}
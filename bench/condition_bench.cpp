@@ -0,0 +1,62 @@
+// File: bench/condition_bench.cpp
+// Conditions as an if or for statement tests them: through value() and a
+// truth test on the resulting Value, against evaluate_bool().
+#include "bench.h"
+#include "Constant.h"
+#include "intern_pool.h"
+#include "scope_man.h"
+#include <cstdio>
+#include <memory>
+
+extern Scope_manager sm;
+
+static long checksum = 0;  // keeps the timed loops from being optimized away
+
+static void run(const char* name, const Expression* expr, int rounds)
+{
+  std::unique_ptr<const Expression> tree(expr);
+  if ((tree->value().as_int() != 0) != tree->evaluate_bool()) {
+    std::printf("%-12s MISMATCH\n", name);
+    return;
+  }
+
+  Stopwatch value_clock;
+  for (int i = 0; i < rounds; i++)
+    checksum += tree->value().as_int() != 0;
+  double value_ms = value_clock.elapsed_ms();
+
+  Stopwatch bool_clock;
+  for (int i = 0; i < rounds; i++)
+    checksum += tree->evaluate_bool();
+  double bool_ms = bool_clock.elapsed_ms();
+
+  std::printf("%-12s value() %7.1f ns  evaluate_bool() %7.1f ns  (%.1fx)\n",
+              name, value_ms * 1e6 / rounds, bool_ms * 1e6 / rounds,
+              value_ms / bool_ms);
+}
+
+int main()
+{
+  const int x = identifiers.intern("x");
+  const int angle = identifiers.intern("angle");
+  sm.add_to_current_scope(new Symbol(x, 7));
+  sm.add_to_current_scope(new Symbol(angle, 30.0));
+  const int rounds = 1000000;
+
+  // x < 10
+  run("compare",
+      make_comparison(gamelang::LESS_THAN, new Variable(x), new Integer_constant(10)),
+      rounds);
+
+  // x < 10 && angle >= 0.5 || !(x == 3)
+  run("logical",
+      new Or(new And(make_comparison(gamelang::LESS_THAN, new Variable(x), new Integer_constant(10)),
+                     make_comparison(gamelang::GREATER_EQUAL, new Variable(angle),
+                                     new Double_constant(0.5))),
+             new Not(make_comparison(gamelang::EQUAL, new Variable(x), new Integer_constant(3)))),
+      rounds);
+
+  // x
+  run("variable", new Variable(x), rounds);
+  return checksum == 0;
+}
@@ -0,0 +1,72 @@
+// File: bench/declaration_bench.cpp
+// Start-up cost of declaring large arrays (int a[n]; double a[n];
+// string a[n];) with n of 1M and 10M: zeroed storage filled one element at
+// a time, as the declaration used to, against Symbol_storage::INDEX.
+#include "bench.h"
+#include "intern_pool.h"
+#include "symbol.h"
+#include <cstdio>
+#include <string>
+
+static long checksum = 0;  // keeps the timed work from being optimized away
+
+// the old declaration: zeroed elements, then element i = i, i + 0.5, "i"
+static void declare_by_element(Symbol* sym)
+{
+  int size = sym->get_count();
+  if (sym->get_type() == gamelang::INT) {
+    int* arr = sym->int_values();
+    for (int i = 0; i < size; i++) arr[i] = i;
+  }
+  else if (sym->get_type() == gamelang::DOUBLE) {
+    double* arr = sym->double_values();
+    for (int i = 0; i < size; i++) arr[i] = i + 0.5;
+  }
+  else {
+    std::string* arr = sym->string_values();
+    for (int i = 0; i < size; i++) arr[i] = std::to_string(i);
+  }
+}
+
+static long last_element(const Symbol* sym)
+{
+  int last = sym->get_count() - 1;
+  switch (sym->get_type()) {
+    case gamelang::INT:    return sym->int_values()[last];
+    case gamelang::DOUBLE: return long(sym->double_values()[last]);
+    default:               return sym->string_values()[last].size();
+  }
+}
+
+static double declare(gamelang::Type type, int size, bool by_element)
+{
+  Symbol_storage::Mark mark = symbol_storage.mark();
+  Stopwatch clock;
+  Symbol* sym = by_element
+    ? new Symbol(identifiers.intern("a"), type, size)
+    : new Symbol(identifiers.intern("a"), type, size, Symbol_storage::INDEX);
+  if (by_element)
+    declare_by_element(sym);
+  double ms = clock.elapsed_ms();
+  checksum += last_element(sym);
+  delete sym;
+  symbol_storage.release(mark);
+  return ms;
+}
+
+int main()
+{
+  const gamelang::Type types[] = {gamelang::INT, gamelang::DOUBLE, gamelang::STRING};
+  for (int size : {1000000, 10000000}) {
+    for (gamelang::Type type : types) {
+      // the first declaration of each size pays for growing the vector
+      declare(type, size, false);
+      double by_element = declare(type, size, true);
+      double indexed = declare(type, size, false);
+      std::printf("%-6s a[%8d]  element by element %8.2f ms  INDEX %8.2f ms  (%.1fx)\n",
+                  gamelang::to_string(type).c_str(), size, by_element, indexed,
+                  by_element / indexed);
+    }
+  }
+  return checksum == 0;
+}
@@ -0,0 +1,133 @@
+// File: bench/math_bench.cpp
+// The trigonometric builtins over an array of 4096 operands: time per
+// element of the scalar libm path the Sin, Cos, ... nodes take against
+// gamelang::apply_math(), and the largest error of each, in ulps of the
+// exact result, over 2^24 random operands (the bounds in math_kernels.h).
+#include "bench.h"
+#include "math_kernels.h"
+#include <cmath>
+#include <cstdio>
+#include <numbers>
+#include <random>
+#include <vector>
+
+static double checksum = 0;  // keeps the timed loops from being optimized away
+
+const long double PI = 3.141592653589793238462643383279502884L;
+
+// what the scalar nodes compute
+static double scalar(gamelang::Operator op, double x)
+{
+  switch (op) {
+    case gamelang::SIN:  return sin(x * (std::numbers::pi / 180.0));
+    case gamelang::COS:  return cos(x * (std::numbers::pi / 180.0));
+    case gamelang::TAN:  return tan(x * (std::numbers::pi / 180.0));
+    case gamelang::ASIN: return asin(x) * (180.0 / std::numbers::pi);
+    case gamelang::ACOS: return acos(x) * (180.0 / std::numbers::pi);
+    default:             return atan(x) * (180.0 / std::numbers::pi);
+  }
+}
+
+// the exact result, near enough: long double, with the degrees reduced
+// exactly to [-45, 45] before they become radians
+static long double reference(gamelang::Operator op, double x)
+{
+  long double n = std::nearbyint(std::fmod((long double) x, 360.0L) / 90.0L);
+  long double r = (std::fmod((long double) x, 360.0L) - 90.0L * n) * (PI / 180.0L);
+  int quadrant = ((int) n % 4 + 4) % 4;
+  long double s = std::sin(r), c = std::cos(r);
+  switch (op) {
+    case gamelang::SIN:  return quadrant == 0 ? s : quadrant == 1 ? c : quadrant == 2 ? -s : -c;
+    case gamelang::COS:  return quadrant == 0 ? c : quadrant == 1 ? -s : quadrant == 2 ? -c : s;
+    case gamelang::TAN:  return quadrant % 2 == 0 ? s / c : -c / s;
+    case gamelang::ASIN: return std::asin((long double) x) * (180.0L / PI);
+    case gamelang::ACOS: return std::acos((long double) x) * (180.0L / PI);
+    default:             return std::atan((long double) x) * (180.0L / PI);
+  }
+}
+
+static double ulps(double result, long double exact)
+{
+  double rounded = (double) exact;
+  if (result == rounded)
+    return 0;
+  if (!std::isfinite(rounded))
+    return std::isfinite(result) ? INFINITY : 0;
+  double ulp = std::nextafter(std::fabs(rounded), INFINITY) - std::fabs(rounded);
+  return (double) (std::fabs(result - exact) / ulp);
+}
+
+static std::vector<double> operands(gamelang::Operator op, int count, std::mt19937_64& random)
+{
+  std::uniform_real_distribution<double> degrees(-720.0, 720.0);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  std::uniform_real_distribution<double> exponent(-8.0, 8.0);
+  std::vector<double> values(count);
+  for (double& x : values) {
+    switch (op) {
+      case gamelang::SIN: case gamelang::COS: case gamelang::TAN:
+        x = degrees(random); break;
+      case gamelang::ASIN: case gamelang::ACOS:
+        x = unit(random); break;
+      default:
+        x = std::copysign(std::pow(10.0, exponent(random)), unit(random)); break;
+    }
+  }
+  return values;
+}
+
+static void run(const char* name, gamelang::Operator op, std::mt19937_64& random)
+{
+  const int count = 4096;
+  const int rounds = 2000;
+  std::vector<double> in = operands(op, count, random);
+  std::vector<double> out(count);
+
+  Stopwatch scalar_clock;
+  for (int round = 0; round < rounds; round++) {
+    for (int i = 0; i < count; i++)
+      out[i] = scalar(op, in[i]);
+    checksum += out[round % count];
+  }
+  double scalar_ms = scalar_clock.elapsed_ms();
+
+  Stopwatch kernel_clock;
+  for (int round = 0; round < rounds; round++) {
+    gamelang::apply_math(op, in.data(), out.data(), count);
+    checksum += out[round % count];
+  }
+  double kernel_ms = kernel_clock.elapsed_ms();
+
+  double worst = 0, worst_scalar = 0, worst_at = 0;
+  for (int batch = 0; batch < (1 << 24) / count; batch++) {
+    in = operands(op, count, random);
+    gamelang::apply_math(op, in.data(), out.data(), count);
+    for (int i = 0; i < count; i++) {
+      long double exact = reference(op, in[i]);
+      double error = ulps(out[i], exact);
+      if (error > worst) {
+        worst = error;
+        worst_at = in[i];
+      }
+      worst_scalar = std::max(worst_scalar, ulps(scalar(op, in[i]), exact));
+    }
+  }
+
+  double per_element = 1e6 / (double(rounds) * count);
+  std::printf("%-5s libm %5.1f ns  apply_math %5.1f ns  (%.1fx)  "
+              "max error %.2f ulp (at %.17g), libm path %.2f ulp\n",
+              name, scalar_ms * per_element, kernel_ms * per_element,
+              scalar_ms / kernel_ms, worst, worst_at, worst_scalar);
+}
+
+int main()
+{
+  std::mt19937_64 random(17);
+  run("sin", gamelang::SIN, random);
+  run("cos", gamelang::COS, random);
+  run("tan", gamelang::TAN, random);
+  run("asin", gamelang::ASIN, random);
+  run("acos", gamelang::ACOS, random);
+  run("atan", gamelang::ATAN, random);
+  std::printf("(checksum %g)\n", checksum);
+}
@@ -0,0 +1,65 @@
+// File: bench/parse_bench.cpp
+// Parse time per MB of a generated level script (declarations, string
+// constants and comments), read through yyin and scanned in place from a
+// Source_buffer mapping (gpl -mmap).
+#include "bench.h"
+#include "source_buffer.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+extern FILE *yyin;
+extern int yyparse();
+int yylex_destroy();
+struct yy_buffer_state *yy_scan_buffer(char *base, size_t size);
+
+// write about megabytes of script; prefix keeps each file's names unique
+static std::string generate(const std::string& prefix, int megabytes)
+{
+  std::string path = (std::filesystem::temp_directory_path()
+                      / ("gpl_parse_bench_" + prefix + ".gpl")).string();
+  std::ofstream out(path);
+  size_t target = size_t(megabytes) << 20;
+  for (int i = 0; size_t(out.tellp()) < target; i++) {
+    std::string n = prefix + std::to_string(i);
+    out << "// tile " << i << " of the generated level\n"
+        << "int " << n << "_x = " << i % 640 << " * 2 + 1;\n"
+        << "double " << n << "_speed = " << i % 7 << ".25 / 2;\n"
+        << "string " << n << "_name = \"tile number " << i << "\";\n";
+  }
+  return path;
+}
+
+static void run(const char* name, bool mapped, int megabytes)
+{
+  std::string path = generate(mapped ? "m" : "f", megabytes);
+  double mb = std::filesystem::file_size(path) / double(1 << 20);
+
+  Stopwatch clock;
+  if (mapped) {
+    source_buffer.map(path);
+    yy_scan_buffer(source_buffer.data(), source_buffer.size());
+  }
+  else
+    yyin = std::fopen(path.c_str(), "r");
+  int result = yyparse();
+  if (yyin)
+    std::fclose(yyin);
+  yyin = nullptr;
+  yylex_destroy();
+  source_buffer.unmap();
+  double ms = clock.elapsed_ms();
+
+  std::printf("%-6s %6.1f MB  %8.1f ms  %6.1f ms/MB%s\n", name, mb, ms,
+              ms / mb, result ? "  (parse failed)" : "");
+  std::filesystem::remove(path);
+}
+
+int main()
+{
+  const int megabytes = 8;
+  run("yyin", false, megabytes);
+  run("mmap", true, megabytes);
+  return 0;
+}
@@ -0,0 +1,68 @@
+// File: bench/scope_bench.cpp
+// Looking up a global from inside 1 to 64 nested scopes: Scope_manager's
+// per-name bindings against searching the scope's tables innermost first
+// (how Scope_manager::lookup used to work).  Every scope declares a few
+// locals of its own, as a nested block would.
+#include "bench.h"
+#include "intern_pool.h"
+#include "scope_man.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+static long checksum = 0;  // keeps the timed loops from being optimized away
+
+static void run(int depth)
+{
+  const long lookups = 2000000;
+  const int locals = 4;
+  std::string prefix = "d" + std::to_string(depth) + "_";
+  int global = identifiers.intern(prefix + "global");
+
+  Scope_manager scopes;
+  std::vector<std::unique_ptr<Symbol_table>> tables;
+  tables.push_back(std::make_unique<Symbol_table>());
+  scopes.add_to_current_scope(new Symbol(global, 1));
+  tables.back()->insert(new Symbol(global, 1));
+  for (int d = 0; d < depth; d++) {
+    scopes.push_table();
+    tables.push_back(std::make_unique<Symbol_table>());
+    for (int i = 0; i < locals; i++) {
+      int id = identifiers.intern(prefix + std::to_string(d) + "_"
+                                  + std::to_string(i));
+      scopes.add_to_current_scope(new Symbol(id, i));
+      tables.back()->insert(new Symbol(id, i));
+    }
+  }
+
+  Stopwatch search_clock;
+  for (long n = 0; n < lookups; n++) {
+    for (auto it = tables.rbegin(); it != tables.rend(); ++it) {
+      if (Symbol* sym = (*it)->lookup(global)) {
+        checksum += sym->get_offset();
+        break;
+      }
+    }
+  }
+  double search_ms = search_clock.elapsed_ms();
+
+  Stopwatch binding_clock;
+  for (long n = 0; n < lookups; n++)
+    checksum += scopes.lookup(global)->get_offset();
+  double binding_ms = binding_clock.elapsed_ms();
+
+  std::printf("%2d scopes  search %7.1f ns  bindings %5.1f ns\n", depth,
+              search_ms * 1e6 / lookups, binding_ms * 1e6 / lookups);
+
+  for (int d = 0; d < depth; d++)
+    scopes.pop_table();
+}
+
+int main()
+{
+  for (int depth = 1; depth <= 64; depth *= 2)
+    run(depth);
+  std::printf("(checksum %ld)\n", checksum);
+  return 0;
+}
@@ -0,0 +1,100 @@
+// File: bench/statement_bench.cpp
+// A 1M-iteration for loop,
+//     for (i = 0; i < 1000000; i += 1) { sum += i % 10; }
+// parsed from a script and run as its Statement_block (one flat list of
+// instructions with pre-linked jumps), against the same statements as a
+// tree of nodes with a virtual execute() each, walked the usual way.
+#include "bench.h"
+#include "Constant.h"
+#include "intern_pool.h"
+#include "scope_man.h"
+#include "statement_block.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+
+extern Scope_manager sm;
+
+static long checksum = 0;  // keeps the timed loops from being optimized away
+
+const int ITERATIONS = 1000000;
+const int RUNS = 5;
+
+// the assignments of the statement tree the block replaces
+struct Int_assign : Statement {
+  Int_assign(const Variable* target, const Expression* value, bool plus)
+    : target(target), value(value), plus(plus) {}
+  void execute() const override {
+    int element = target->element();
+    if (element < 0)
+      return;
+    Value v = value->value();
+    int& slot = target->get_symbol()->int_values()[element];
+    slot = plus ? slot + v.as_int() : v.as_int();
+  }
+  std::unique_ptr<const Variable> target;
+  std::unique_ptr<const Expression> value;
+  bool plus;
+};
+
+static const Statement_block* parse_block()
+{
+  std::string program = "int i;\n"
+                        "int sum;\n"
+                        "initialization {\n"
+                        "  for (i = 0; i < " + std::to_string(ITERATIONS) + "; i += 1) {\n"
+                        "    sum += i % 10;\n"
+                        "  }\n"
+                        "}\n";
+  if (!parse_program(program, "gpl_statement_bench.gpl") || statement_builder.blocks().empty())
+    return nullptr;
+  return statement_builder.blocks().front().get();
+}
+
+static For* build_tree(int i, int sum)
+{
+  For* loop = new For;
+  loop->init.reset(new Int_assign(new Variable(i), new Integer_constant(0), false));
+  loop->condition.reset(make_comparison(gamelang::LESS_THAN, new Variable(i),
+                                        new Integer_constant(ITERATIONS)));
+  loop->update.reset(new Int_assign(new Variable(i), new Integer_constant(1), true));
+  Block* body = new Block;
+  body->statements.emplace_back(
+    new Int_assign(new Variable(sum), new Mod(new Variable(i), new Integer_constant(10)), true));
+  loop->body.reset(body);
+  return loop;
+}
+
+int main()
+{
+  const Statement_block* block = parse_block();
+  if (!block) {
+    std::printf("parse failed\n");
+    return 1;
+  }
+  Symbol* sum = sm.lookup(identifiers.intern("sum"));
+  std::unique_ptr<For> tree(build_tree(identifiers.intern("i"), identifiers.intern("sum")));
+
+  // the fastest of a few runs of each, so one slow run does not decide it
+  double tree_ms = 0, block_ms = 0;
+  for (int run = 0; run < RUNS; run++) {
+    sum->int_values()[0] = 0;
+    Stopwatch tree_clock;
+    tree->execute();
+    double ms = tree_clock.elapsed_ms();
+    tree_ms = run == 0 || ms < tree_ms ? ms : tree_ms;
+    checksum += sum->int_values()[0];
+
+    sum->int_values()[0] = 0;
+    Stopwatch block_clock;
+    block->execute();
+    ms = block_clock.elapsed_ms();
+    block_ms = run == 0 || ms < block_ms ? ms : block_ms;
+    checksum += sum->int_values()[0];
+  }
+
+  std::printf("%d iterations (%d instructions)  tree %7.2f ms  block %7.2f ms  (%.2fx)  "
+              "sum %d\n", ITERATIONS, block->size(), tree_ms, block_ms,
+              tree_ms / block_ms, sum->int_values()[0]);
+  return checksum == 0;
+}
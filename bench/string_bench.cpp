@@ -0,0 +1,95 @@
+// File: bench/string_bench.cpp
+// Heap allocations and time per evaluation of string comparisons between
+// string variables and constants longer than the small-string buffer, and
+// of one expression that concatenates 10k pieces, tree-walked and compiled.
+#include "bench.h"
+#include "Bytecode.h"
+#include "Constant.h"
+#include "intern_pool.h"
+#include "scope_man.h"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+extern Scope_manager sm;
+
+static long allocations = 0;
+
+void* operator new(std::size_t size)
+{
+  allocations++;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static long checksum = 0;  // keeps the timed loops from being optimized away
+
+static void run(const char* name, const Expression* expr, int rounds)
+{
+  std::unique_ptr<const Expression> tree(expr);
+  long before = allocations;
+  Stopwatch clock;
+  for (int i = 0; i < rounds; i++)
+    checksum += tree->evaluate_bool();
+  double ms = clock.elapsed_ms();
+  std::printf("%-20s %5.2f allocations/evaluation  %7.1f ns\n", name,
+              double(allocations - before) / rounds, ms * 1e6 / rounds);
+}
+
+// "piece 0 " + "piece 1 " + ... + "piece <count-1> ", left to right as the
+// parser builds it
+static void concatenate(int count)
+{
+  const Expression* e = new String_constant("piece 0 ");
+  for (int i = 1; i < count; i++)
+    e = new Add(e, new String_constant("piece " + std::to_string(i) + " "));
+  std::unique_ptr<const Expression> tree(e);
+  Bytecode bytecode(tree.get());
+
+  long before = allocations;
+  Stopwatch tree_clock;
+  size_t length = tree->value().as_string().size();
+  double tree_ms = tree_clock.elapsed_ms();
+  long tree_allocations = allocations - before;
+
+  before = allocations;
+  Stopwatch bytecode_clock;
+  size_t bytecode_length = bytecode.run().as_string().size();
+  double bytecode_ms = bytecode_clock.elapsed_ms();
+  long bytecode_allocations = allocations - before;
+
+  std::printf("concatenate %d pieces (%zu chars%s)\n", count, length,
+              length == bytecode_length ? "" : ", MISMATCH");
+  std::printf("  tree      %8.3f ms  %6ld allocations\n", tree_ms,
+              tree_allocations);
+  std::printf("  bytecode  %8.3f ms  %6ld allocations\n", bytecode_ms,
+              bytecode_allocations);
+}
+
+int main()
+{
+  const int player = identifiers.intern("player");
+  const int level = identifiers.intern("level");
+  sm.add_to_current_scope(new Symbol(player, std::string("player one, the red knight")));
+  sm.add_to_current_scope(new Symbol(level, 12));
+  const int rounds = 1000000;
+
+  run("variable == constant",
+      make_comparison(gamelang::EQUAL, new Variable(player),
+                      new String_constant("player one, the red knight")),
+      rounds);
+  run("constant < variable",
+      make_comparison(gamelang::LESS_THAN,
+                      new String_constant("player one, the blue knight"),
+                      new Variable(player)),
+      rounds);
+  run("variable != int",
+      make_comparison(gamelang::NOT_EQUAL, new Variable(player), new Variable(level)),
+      rounds);
+  concatenate(10000);
+  return checksum == 0;
+}
@@ -0,0 +1,106 @@
+// File: bench/value_bench.cpp
+// Heap allocations and time per evaluated node: the Constant* adapter
+// (Expression::evaluate) against the by-value path (Expression::value),
+// and evaluate() of a literal: a copy of a Constant built by hand against
+// the shared one from literals, which returns itself.
+// Nodes come from ast_arena, so its allocations are counted as well.
+#include "bench.h"
+#include "Constant.h"
+#include "arena.h"
+#include "literal_pool.h"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+static long heap_allocations = 0;
+
+static long allocations()
+{
+  return heap_allocations + ast_arena.stats().nodes;
+}
+
+void* operator new(std::size_t size)
+{
+  heap_allocations++;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// allocations and ns per evaluate() of a literal, printed under name
+static void evaluate_literal(const char* name, const Expression* literal, int rounds)
+{
+  long before = allocations();
+  Stopwatch clock;
+  long length = 0;
+  for (int i = 0; i < rounds; i++) {
+    Constant_ptr c = literal->evaluate();
+    length += c->type();
+  }
+  double ms = clock.elapsed_ms();
+  std::printf("%-34s %6.3f allocations/evaluation %7.2f ns/evaluation (%ld)\n", name,
+              double(allocations() - before) / rounds, ms * 1e6 / rounds, length);
+}
+
+// builds ((((1 + 2.5) * 3) - 4) + 2.5) * 3 ... with the given number of
+// operators; every operator contributes two nodes (itself and a literal)
+static const Expression* build(int operators, int& nodes)
+{
+  const Expression* e = new Integer_constant(1);
+  nodes = 1;
+  for (int i = 0; i < operators; i++) {
+    switch (i % 3) {
+      case 0: e = new Add(e, new Double_constant(2.5)); break;
+      case 1: e = new Multiply(e, new Integer_constant(3)); break;
+      case 2: e = new Subtract(e, new Integer_constant(4)); break;
+    }
+    nodes += 2;
+  }
+  return e;
+}
+
+int main()
+{
+  const int operators = 300;
+  const int rounds = 2000;
+  int nodes;
+  std::unique_ptr<const Expression> tree(build(operators, nodes));
+
+  long before = allocations();
+  Stopwatch adapter_clock;
+  double sum = 0;
+  for (int i = 0; i < rounds; i++) {
+    Constant_ptr c = tree->evaluate();
+    sum += c->as_double();
+  }
+  double adapter_ms = adapter_clock.elapsed_ms();
+  long adapter_allocations = allocations() - before;
+
+  before = allocations();
+  Stopwatch value_clock;
+  for (int i = 0; i < rounds; i++)
+    sum -= tree->value().as_double();
+  double value_ms = value_clock.elapsed_ms();
+  long value_allocations = allocations() - before;
+
+  double evaluated = double(nodes) * rounds;
+  std::printf("%d nodes x %d rounds (checksum %g)\n", nodes, rounds, sum);
+  std::printf("evaluate(): %6.3f allocations/evaluation %6.4f allocations/node"
+              " %7.2f ns/node\n", double(adapter_allocations) / rounds,
+              adapter_allocations / evaluated, adapter_ms * 1e6 / evaluated);
+  std::printf("value():    %6.3f allocations/evaluation %6.4f allocations/node"
+              " %7.2f ns/node\n", double(value_allocations) / rounds,
+              value_allocations / evaluated, value_ms * 1e6 / evaluated);
+
+  const std::string text = "a string literal too long for the inline buffer";
+  std::unique_ptr<const Expression> copied(new String_constant(text));
+  evaluate_literal("evaluate() of a string, copied", copied.get(), 1000000);
+  evaluate_literal("evaluate() of a string, pooled", literals.string(text), 1000000);
+  std::unique_ptr<const Expression> copied_int(new Integer_constant(1));
+  evaluate_literal("evaluate() of true, copied", copied_int.get(), 1000000);
+  evaluate_literal("evaluate() of true, pooled", literals.integer(1), 1000000);
+  return 0;
+}
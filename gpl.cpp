@@ -16,20 +16,50 @@ extern Scope_manager sm;
 #endif
 
 #include "error.h"
+#include "source_buffer.h"
+#include "arena.h"
+#include "statement_block.h"
 
 #ifdef GRAPHICS
 #include <cassert>
+#include <type_traits>
 #include "types_and_ops.h"
 #include "Window.h"
 #include "Constant.h"
 
 std::unique_ptr<Window> window;
 
+// A program that declares a reserved variable overrides its default in
+// value.  The symbol's declared type is checked against expected up front,
+// so a wrong type is reported without a conversion ever being attempted.
+template <typename T>
+static void read_reserved(const char* name, gamelang::Type expected, T& value)
+{
+  Symbol* symbol = sm.lookup(name);
+  if (!symbol)
+    return;
+  if (!gamelang::converts_to(symbol->get_type(), expected)) {
+    gamelang::error(gamelang::INVALID_TYPE_FOR_RESERVED_VARIABLE, name,
+                    gamelang::to_string(symbol->get_type()), gamelang::to_string(expected));
+    return;
+  }
+  Value v = symbol->as_value();
+  if (!v.is_valid())
+    return;  // declared as an array
+  if constexpr (std::is_same_v<T, int>)
+    value = v.as_int();
+  else if constexpr (std::is_same_v<T, double>)
+    value = v.as_double();
+  else
+    value = v.as_string();
+}
+
 #endif
 
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <cstdlib>
 #include <cstring>
 #include <string>
@@ -44,6 +74,7 @@ using namespace std;
 
 extern int yylex();
 extern int yyparse();
+struct yy_buffer_state *yy_scan_buffer(char *base, size_t size);
 
 int yyerror(const char *str)
 {
@@ -54,7 +85,7 @@ int yyerror(const char *str)
 void illegal_usage(const char *qualifier = nullptr)
 {
   cerr << "illegal command line argument(s)" << endl
-    << "Usage:  $ gpl [-s seed] [-stdin] [-dump_pixels filename] filename[.gpl]" << endl;
+    << "Usage:  $ gpl [-s seed] [-stdin] [-mmap] [-arena_stats] [-dump_pixels filename] filename[.gpl]" << endl;
 
   if (qualifier)
     cerr << qualifier << endl;
@@ -63,6 +94,17 @@ void illegal_usage(const char *qualifier = nullptr)
 
 }
 
+// -arena_stats: report how much the parser allocated from ast_arena
+// (sent to cerr so the .out files don't change)
+void print_arena_stats()
+{
+  Arena::Stats stats = ast_arena.stats();
+  cerr << "arena: " << stats.nodes << " nodes ("
+    << stats.live_nodes << " live at exit), "
+    << stats.bytes << " bytes, "
+    << stats.chunks << " chunks (" << stats.chunk_bytes << " bytes)" << endl;
+}
+
 bool dump_pixels = false;
 char *dump_pixels_filename = 0;
 bool graphics_flag = false;
@@ -108,11 +150,16 @@ int main(int argc, char **argv)
   char *filename = 0;
   int seed = time(0);
   bool read_keypresses_from_standard_input = false;
+  bool map_input_file = false;
 
   for (int i = 1; i < argc; i++)
   {
     if (!strcmp(argv[i], "-stdin"))
       read_keypresses_from_standard_input = true;
+    else if (!strcmp(argv[i], "-mmap"))
+      map_input_file = true;
+    else if (!strcmp(argv[i], "-arena_stats"))
+      atexit(print_arena_stats);
     else if (!strcmp(argv[i], "-s"))
     {
       if (i+1 >= argc)
@@ -156,18 +203,31 @@ int main(int argc, char **argv)
     illegal_usage();
 
 
-  yyin = fopen(filename,"r");
-
-  // if open failed, append .gpl to the filename and try again
   string string_filename=filename;
-  if (!yyin)
+  bool opened;
+  if (map_input_file)
   {
-    string filename_with_extension=string_filename+".gpl";
-    yyin = fopen(filename_with_extension.c_str(),"r");
+    // scan the file where it is mapped instead of reading it through yyin
+    opened = source_buffer.map(string_filename)
+      || source_buffer.map(string_filename+".gpl");
+    if (opened)
+      yy_scan_buffer(source_buffer.data(), source_buffer.size());
+  }
+  else
+  {
+    yyin = fopen(filename,"r");
+
+    // if open failed, append .gpl to the filename and try again
+    if (!yyin)
+    {
+      string filename_with_extension=string_filename+".gpl";
+      yyin = fopen(filename_with_extension.c_str(),"r");
+    }
+    opened = yyin != nullptr;
   }
 
   // cannot open filename or filename+.gpl
-  if (!yyin)
+  if (!opened)
   {
     cerr << "Cannot open input file <" << filename << ">." << endl;
     return 1;
@@ -194,10 +254,12 @@ int main(int argc, char **argv)
   cout << "gpl.cpp::main() Calling yyparse()" << endl << endl;
 
   int parse_result = yyparse();
-  fclose(yyin);
+  if (yyin)
+    fclose(yyin);
 
   int yylex_destroy  (void);//gratuitous prototype
   yylex_destroy();
+  source_buffer.unmap();
   cout << endl << "gpl.cpp::main() after call to yyparse()."<<endl<< endl;
 
   gamelang::starting_execution();
@@ -205,16 +267,6 @@ int main(int argc, char **argv)
 
   // if -DGRAPHICS was specified when compiling gpl.cpp then include this code
 #ifdef GRAPHICS
-  int window_x;
-  int window_y;
-  int window_width;
-  int window_height;
-  double window_red;
-  double window_green;
-  double window_blue;
-  string window_title;
-  int animation_speed;
-
   // A user defining a reserved variable overrides the default value.
   // If the user defines the reserved variable with the incorrect type,
   // an error is generated.
@@ -230,43 +282,25 @@ int main(int argc, char **argv)
   const string DEFAULT_WINDOW_TITLE = "gpl window";
   const int DEFAULT_ANIMATION_SPEED = 88;
 
-  Symbol* symbol;
-
-  try { window_x=(symbol=sm.lookup("window_x")) ? 
-    std::unique_ptr<const Constant>(symbol->as_constant())->as_int() : DEFAULT_WINDOW_X; }
-  catch(gamelang::Type badtype) { gamelang::error(gamelang::INVALID_TYPE_FOR_RESERVED_VARIABLE, "window_x", to_string(badtype), "int"); }
-
-  try { window_y=(symbol=sm.lookup("window_y")) ? 
-    std::unique_ptr<const Constant>(symbol->as_constant())->as_int() : DEFAULT_WINDOW_Y; }
-  catch(gamelang::Type badtype) { gamelang::error(gamelang::INVALID_TYPE_FOR_RESERVED_VARIABLE, "window_y", to_string(badtype), "int"); }
-
-  try { window_width=(symbol=sm.lookup("window_width")) ? 
-    std::unique_ptr<const Constant>(symbol->as_constant())->as_int() : DEFAULT_WINDOW_WIDTH; }
-  catch(gamelang::Type badtype) { gamelang::error(gamelang::INVALID_TYPE_FOR_RESERVED_VARIABLE, "window_width", to_string(badtype), "int"); }
-
-  try { window_height=(symbol=sm.lookup("window_height")) ? 
-    std::unique_ptr<const Constant>(symbol->as_constant())->as_int() : DEFAULT_WINDOW_HEIGHT; }
-  catch(gamelang::Type badtype) { gamelang::error(gamelang::INVALID_TYPE_FOR_RESERVED_VARIABLE, "window_height", to_string(badtype), "int"); }
-
-  try { window_red=(symbol=sm.lookup("window_red")) ? 
-    std::unique_ptr<const Constant>(symbol->as_constant())->as_double() : DEFAULT_WINDOW_RED; }
-  catch(gamelang::Type badtype) { gamelang::error(gamelang::INVALID_TYPE_FOR_RESERVED_VARIABLE, "window_red", to_string(badtype), "double"); }
-
-  try { window_green=(symbol=sm.lookup("window_green")) ? 
-    std::unique_ptr<const Constant>(symbol->as_constant())->as_double() : DEFAULT_WINDOW_GREEN; }
-  catch(gamelang::Type badtype) { gamelang::error(gamelang::INVALID_TYPE_FOR_RESERVED_VARIABLE, "window_green", to_string(badtype), "double"); }
-
-  try { window_blue=(symbol=sm.lookup("window_blue")) ? 
-    std::unique_ptr<const Constant>(symbol->as_constant())->as_double() : DEFAULT_WINDOW_BLUE; }
-  catch(gamelang::Type badtype) { gamelang::error(gamelang::INVALID_TYPE_FOR_RESERVED_VARIABLE, "window_blue", to_string(badtype), "double"); }
-
-  try { window_title=(symbol=sm.lookup("window_title")) ? 
-    std::unique_ptr<const Constant>(symbol->as_constant())->as_string() : DEFAULT_WINDOW_TITLE; }
-  catch(gamelang::Type badtype) { gamelang::error(gamelang::INVALID_TYPE_FOR_RESERVED_VARIABLE, "window_title", to_string(badtype), "string"); }
-
-  try { animation_speed=(symbol=sm.lookup("animation_speed")) ? 
-    std::unique_ptr<const Constant>(symbol->as_constant())->as_int() : DEFAULT_ANIMATION_SPEED; }
-  catch(gamelang::Type badtype) { gamelang::error(gamelang::INVALID_TYPE_FOR_RESERVED_VARIABLE, "animation_speed", to_string(badtype), "int"); }
+  int window_x = DEFAULT_WINDOW_X;
+  int window_y = DEFAULT_WINDOW_Y;
+  int window_width = DEFAULT_WINDOW_WIDTH;
+  int window_height = DEFAULT_WINDOW_HEIGHT;
+  double window_red = DEFAULT_WINDOW_RED;
+  double window_green = DEFAULT_WINDOW_GREEN;
+  double window_blue = DEFAULT_WINDOW_BLUE;
+  string window_title = DEFAULT_WINDOW_TITLE;
+  int animation_speed = DEFAULT_ANIMATION_SPEED;
+
+  read_reserved("window_x", gamelang::INT, window_x);
+  read_reserved("window_y", gamelang::INT, window_y);
+  read_reserved("window_width", gamelang::INT, window_width);
+  read_reserved("window_height", gamelang::INT, window_height);
+  read_reserved("window_red", gamelang::DOUBLE, window_red);
+  read_reserved("window_green", gamelang::DOUBLE, window_green);
+  read_reserved("window_blue", gamelang::DOUBLE, window_blue);
+  read_reserved("window_title", gamelang::STRING, window_title);
+  read_reserved("animation_speed", gamelang::INT, animation_speed);
 
 #endif
 
@@ -295,10 +329,21 @@ int main(int argc, char **argv)
       << endl
       << endl;
   }
+
+  // without a window nothing else happens to the program, so its
+  // initialization blocks run once here, before the symbol table is
+  // printed; an exit statement stops them
+  std::optional<int> exit_status;
+  for (const auto& block : statement_builder.blocks())
+  {
+    if (block->get_kind() == Statement_block::INITIALIZATION && !exit_status)
+      exit_status = block->execute();
+  }
 #endif
 
 #ifdef SYM_TAB
-  if (parse_result == 0 && gamelang::num_errors() == 0)
+  // errors from running the initialization blocks do not stop it
+  if (parse_result == 0)
   {
     cout << endl << "Printing the symbol table from main()" << endl;
     cout << sm;
@@ -309,6 +354,7 @@ int main(int argc, char **argv)
   cout << "Graphics is turned off by the Makefile.  Program exiting."
     << endl << endl;
   cout << "gpl.cpp::main() done." << endl;
+  return exit_status.value_or(0);
 #else
   window = std::make_unique<Window>(window_x, window_y, window_width,
       window_height, window_title, animation_speed,
@@ -67,11 +67,21 @@
 
 
 /* First part of user prologue.  */
-#line 14 "gpl.y"
+#line 16 "gpl.y"
 
 #include "scope_man.h"
+#include "intern_pool.h"
 #include "Constant.h"
+#include "arena.h"
+#include "literal_pool.h"
+#include "statement_block.h"
+// ast_arena must be defined before sm so it outlives the symbols sm owns,
+// before literals, whose Constants it holds, and before statement_builder,
+// whose blocks own the statements' expressions
+Arena ast_arena;
+Literal_pool literals;
 Scope_manager sm;
+Statement_builder statement_builder;
 extern int yylex();  // prototype of function generated by flex
 extern int yyerror(const char *); // used to print errors
 extern int line_count;            // current line in the input; from record.l
@@ -79,9 +89,13 @@ extern int line_count;            // current line in the input; from record.l
 #include "error.h"      // class for printing errors (used by gpl)
 #include <iostream>
 
+// a declaration's initial value may nest far deeper than bison's default
+// limit of 10000 states; the parser stack is malloc'd, so let it grow
+#define YYMAXDEPTH (1 << 24)
+
 // bison syntax indicating the end of a C/C++ code section
 
-#line 85 "gpl.tab.c"
+#line 99 "gpl.tab.c"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -219,26 +233,33 @@ enum yysymbol_kind_t
   YYSYMBOL_block_list = 107,               /* block_list  */
   YYSYMBOL_block = 108,                    /* block  */
   YYSYMBOL_initialization_block = 109,     /* initialization_block  */
-  YYSYMBOL_termination_block = 110,        /* termination_block  */
-  YYSYMBOL_forward_declaration = 111,      /* forward_declaration  */
-  YYSYMBOL_animation_parameter = 112,      /* animation_parameter  */
-  YYSYMBOL_animation_block = 113,          /* animation_block  */
-  YYSYMBOL_animation_declaration = 114,    /* animation_declaration  */
-  YYSYMBOL_on_block = 115,                 /* on_block  */
-  YYSYMBOL_keystroke = 116,                /* keystroke  */
-  YYSYMBOL_statement_or_block_of_statements = 117, /* statement_or_block_of_statements  */
-  YYSYMBOL_statement_block = 118,          /* statement_block  */
-  YYSYMBOL_statement_list = 119,           /* statement_list  */
-  YYSYMBOL_statement = 120,                /* statement  */
-  YYSYMBOL_if_statement = 121,             /* if_statement  */
-  YYSYMBOL_for_statement = 122,            /* for_statement  */
-  YYSYMBOL_print_statement = 123,          /* print_statement  */
-  YYSYMBOL_exit_statement = 124,           /* exit_statement  */
-  YYSYMBOL_assign_statement_or_empty = 125, /* assign_statement_or_empty  */
-  YYSYMBOL_assign_statement = 126,         /* assign_statement  */
-  YYSYMBOL_variable = 127,                 /* variable  */
-  YYSYMBOL_expression = 128,               /* expression  */
-  YYSYMBOL_primary_expression = 129        /* primary_expression  */
+  YYSYMBOL_110_1 = 110,                    /* $@1  */
+  YYSYMBOL_termination_block = 111,        /* termination_block  */
+  YYSYMBOL_112_2 = 112,                    /* $@2  */
+  YYSYMBOL_forward_declaration = 113,      /* forward_declaration  */
+  YYSYMBOL_animation_parameter = 114,      /* animation_parameter  */
+  YYSYMBOL_animation_block = 115,          /* animation_block  */
+  YYSYMBOL_116_3 = 116,                    /* $@3  */
+  YYSYMBOL_animation_declaration = 117,    /* animation_declaration  */
+  YYSYMBOL_on_block = 118,                 /* on_block  */
+  YYSYMBOL_119_4 = 119,                    /* $@4  */
+  YYSYMBOL_keystroke = 120,                /* keystroke  */
+  YYSYMBOL_statement_or_block_of_statements = 121, /* statement_or_block_of_statements  */
+  YYSYMBOL_statement_block = 122,          /* statement_block  */
+  YYSYMBOL_statement_list = 123,           /* statement_list  */
+  YYSYMBOL_statement = 124,                /* statement  */
+  YYSYMBOL_if_statement = 125,             /* if_statement  */
+  YYSYMBOL_126_5 = 126,                    /* @5  */
+  YYSYMBOL_if_header = 127,                /* if_header  */
+  YYSYMBOL_for_statement = 128,            /* for_statement  */
+  YYSYMBOL_129_6 = 129,                    /* $@6  */
+  YYSYMBOL_print_statement = 130,          /* print_statement  */
+  YYSYMBOL_exit_statement = 131,           /* exit_statement  */
+  YYSYMBOL_assign_statement_or_empty = 132, /* assign_statement_or_empty  */
+  YYSYMBOL_assign_statement = 133,         /* assign_statement  */
+  YYSYMBOL_variable = 134,                 /* variable  */
+  YYSYMBOL_expression = 135,               /* expression  */
+  YYSYMBOL_primary_expression = 136        /* primary_expression  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -566,16 +587,16 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  3
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   626
+#define YYLAST   627
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  95
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  35
+#define YYNNTS  42
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  127
+#define YYNRULES  134
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  238
+#define YYNSTATES  245
 
 /* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   349
@@ -633,19 +654,20 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   177,   177,   182,   183,   188,   189,   190,   195,   302,
-     358,   359,   360,   365,   366,   371,   372,   377,   378,   379,
-     380,   381,   386,   387,   388,   393,   394,   399,   404,   405,
-     410,   411,   412,   413,   418,   423,   428,   433,   434,   439,
-     444,   449,   454,   455,   456,   457,   458,   459,   460,   461,
-     462,   463,   464,   465,   466,   467,   468,   469,   470,   471,
-     472,   473,   474,   475,   476,   477,   482,   483,   488,   489,
-     495,   496,   501,   502,   503,   504,   505,   510,   511,   516,
-     521,   526,   531,   532,   537,   538,   539,   540,   541,   546,
-     550,   554,   559,   568,   571,   572,   573,   574,   575,   576,
-     577,   578,   579,   580,   597,   614,   631,   648,   658,   659,
-     660,   664,   665,   666,   667,   668,   669,   670,   671,   672,
-     673,   678,   679,   680,   681,   682,   683,   684
+       0,   196,   196,   201,   202,   207,   208,   209,   214,   258,
+     294,   295,   296,   301,   302,   307,   308,   313,   314,   315,
+     316,   317,   322,   323,   324,   329,   330,   335,   340,   341,
+     346,   347,   348,   349,   354,   354,   364,   364,   374,   379,
+     380,   385,   385,   395,   400,   400,   410,   411,   412,   413,
+     414,   415,   416,   417,   418,   419,   420,   421,   422,   423,
+     424,   425,   426,   427,   428,   429,   430,   431,   432,   433,
+     438,   439,   444,   445,   451,   452,   457,   458,   459,   460,
+     461,   466,   469,   469,   479,   486,   486,   498,   505,   512,
+     513,   518,   522,   526,   530,   534,   542,   545,   549,   552,
+     559,   562,   563,   564,   565,   566,   567,   568,   569,   570,
+     571,   588,   605,   622,   639,   649,   650,   651,   655,   656,
+     657,   658,   659,   660,   661,   662,   663,   664,   669,   670,
+     671,   672,   673,   674,   675
 };
 #endif
 
@@ -683,13 +705,13 @@ static const char *const yytname[] =
   "declaration_list", "declaration", "variable_declaration", "simple_type",
   "optional_initializer", "object_declaration", "object_type",
   "parameter_list_or_empty", "parameter_list", "parameter", "block_list",
-  "block", "initialization_block", "termination_block",
-  "forward_declaration", "animation_parameter", "animation_block",
-  "animation_declaration", "on_block", "keystroke",
+  "block", "initialization_block", "$@1", "termination_block", "$@2",
+  "forward_declaration", "animation_parameter", "animation_block", "$@3",
+  "animation_declaration", "on_block", "$@4", "keystroke",
   "statement_or_block_of_statements", "statement_block", "statement_list",
-  "statement", "if_statement", "for_statement", "print_statement",
-  "exit_statement", "assign_statement_or_empty", "assign_statement",
-  "variable", "expression", "primary_expression", YY_NULLPTR
+  "statement", "if_statement", "@5", "if_header", "for_statement", "$@6",
+  "print_statement", "exit_statement", "assign_statement_or_empty",
+  "assign_statement", "variable", "expression", "primary_expression", YY_NULLPTR
 };
 
 static const char *
@@ -699,7 +721,7 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-154)
+#define YYPACT_NINF (-188)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
@@ -713,79 +735,83 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-    -154,     4,   615,  -154,  -154,  -154,  -154,  -154,  -154,  -154,
-    -154,  -154,     1,  -154,   -30,   -39,     8,   -32,   125,    17,
-      -6,  -154,    13,  -154,    46,    60,    60,   534,    20,  -154,
-    -154,  -154,  -154,    60,  -154,  -154,    65,   148,   148,  -154,
-     -38,   148,  -154,   -11,  -154,  -154,  -154,  -154,  -154,  -154,
-    -154,  -154,  -154,  -154,  -154,  -154,  -154,  -154,  -154,  -154,
-    -154,  -154,  -154,  -154,  -154,  -154,  -154,  -154,  -154,  -154,
-      60,    87,  -154,   196,  -154,  -154,   148,    99,   101,   102,
-     116,   120,   121,   131,   137,   140,   147,   148,   148,  -154,
-    -154,  -154,    43,  -154,    79,  -154,   -45,  -154,    91,   -35,
-    -154,   423,   150,   151,   152,   153,  -154,    -5,  -154,  -154,
-    -154,   113,   154,   167,   169,  -154,   196,   132,   173,   171,
-     148,   148,   148,   148,   148,   148,   148,   148,   148,   148,
-     -29,   -29,   148,   133,  -154,   148,   148,   148,   148,   148,
-     148,   148,   148,   148,   148,   148,   148,   148,   148,   148,
-     148,  -154,   141,  -154,   148,   143,   148,   148,  -154,  -154,
-    -154,  -154,  -154,   148,   148,   148,  -154,  -154,   144,  -154,
-    -154,  -154,   191,   207,   227,   243,   263,   279,   299,   315,
-     335,   351,   439,  -154,   159,    11,   119,    -9,   109,   -24,
-     -29,     0,     0,    15,   100,   523,   536,   510,   455,   -45,
-    -154,   371,   187,  -154,   387,   407,   -45,   -45,   -45,   193,
-    -154,  -154,  -154,  -154,  -154,  -154,  -154,  -154,  -154,  -154,
-     203,    40,   148,  -154,  -154,  -154,   170,   241,   470,  -154,
-      40,   143,  -154,   213,     5,  -154,  -154,  -154
+    -188,     5,   609,  -188,  -188,  -188,  -188,  -188,  -188,  -188,
+    -188,  -188,    -4,  -188,   -25,   -59,   -16,   -31,   156,    -7,
+     -23,  -188,   -49,  -188,   -17,  -188,  -188,   514,   -19,  -188,
+    -188,  -188,  -188,  -188,  -188,  -188,    40,   112,   112,  -188,
+     -36,   112,  -188,    34,    34,  -188,  -188,  -188,  -188,  -188,
+    -188,  -188,  -188,  -188,  -188,  -188,  -188,  -188,  -188,  -188,
+    -188,  -188,  -188,  -188,  -188,  -188,  -188,  -188,  -188,  -188,
+      60,    34,   154,  -188,  -188,   112,    63,    65,    68,    69,
+      70,    80,    83,    84,    85,   101,   112,   112,  -188,  -188,
+    -188,   -41,  -188,   387,  -188,   490,  -188,    93,   -45,  -188,
+     403,    16,  -188,  -188,    34,   154,  -188,    -6,   103,   135,
+     112,   112,   112,   112,   112,   112,   112,   112,   112,   112,
+     -14,   -14,   112,    62,  -188,   112,   112,   112,   112,   112,
+     112,   112,   112,   112,   112,   112,   112,   112,   112,   112,
+     112,  -188,    66,  -188,   107,   125,   137,   138,  -188,    36,
+    -188,  -188,    28,  -188,   134,   142,   145,   133,  -188,    96,
+    -188,  -188,  -188,   155,   171,   191,   207,   227,   243,   263,
+     279,   299,   315,   419,  -188,   151,    -2,    -9,    37,   -56,
+     -48,   -14,    48,    48,   530,   550,    64,   519,   506,   435,
+     490,  -188,   112,   114,   112,   112,  -188,  -188,   187,  -188,
+    -188,  -188,   112,   112,   112,  -188,  -188,   175,  -188,  -188,
+    -188,  -188,  -188,  -188,  -188,  -188,  -188,  -188,   169,   335,
+     172,  -188,   351,   371,  -188,   490,   490,   490,  -188,   168,
+    -188,   112,  -188,  -188,    28,  -188,   450,  -188,   114,   211,
+    -188,    23,  -188,  -188,  -188
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
    Performed when YYTABLE does not specify something else to do.  Zero
    means the default is an error.  */
-static const yytype_int8 yydefact[] =
+static const yytype_uint8 yydefact[] =
 {
        4,     0,    29,     1,    10,    11,    12,    17,    18,    19,
       20,    21,     0,     3,     0,     0,     0,     0,     2,     0,
-       0,     5,    14,     6,    24,     0,     0,     0,     0,    28,
-      30,    31,    32,     0,    33,     7,     0,     0,     0,     8,
-       0,     0,    15,     0,    34,    35,    42,    45,    46,    43,
-      44,    47,    48,    49,    50,    51,    52,    53,    54,    65,
-      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
-       0,     0,    39,     0,   124,   125,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,   123,
-     126,   127,    89,   122,     0,    93,    13,    23,     0,     0,
-      26,     0,     0,     0,     0,     0,    69,     0,    71,    72,
-      73,     0,     0,     0,     0,    41,     0,    38,     0,     0,
+       0,     5,    14,     6,    24,    34,    36,     0,     0,    28,
+      30,    31,    32,    41,    33,     7,     0,     0,     0,     8,
+       0,     0,    15,     0,     0,    46,    49,    50,    47,    48,
+      51,    52,    53,    54,    55,    56,    57,    58,    69,    59,
+      60,    61,    62,    63,    64,    65,    66,    67,    68,    44,
+       0,     0,     0,   131,   132,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,   130,   133,
+     134,    96,   129,     0,   100,    13,    23,     0,     0,    26,
+       0,     0,    35,    37,     0,     0,    42,    40,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-     107,   108,     0,     0,     9,     0,     0,     0,     0,     0,
+     114,   115,     0,     0,     9,     0,     0,     0,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,    22,     0,    16,     0,    83,     0,     0,    68,    70,
-      75,    76,    74,     0,     0,     0,    87,    88,     0,    37,
-      36,   121,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,    91,   110,   109,   104,   105,   102,   103,
-     106,    98,    99,    96,    97,   100,   101,    95,    94,    27,
-      25,     0,     0,    82,     0,     0,    84,    85,    86,     0,
-     111,   112,   113,   114,   115,   116,   117,   118,   119,   120,
-      90,     0,     0,    81,    80,    40,     0,    77,     0,    92,
-       0,    83,    78,     0,     0,    79,    66,    67
+       0,    22,     0,    16,     0,     0,     0,     0,    73,     0,
+      75,    76,     0,    77,     0,     0,     0,     0,    45,     0,
+      39,    38,   128,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,    98,   117,   116,   111,   112,   109,
+     110,   113,   105,   106,   103,   104,   107,   108,   102,   101,
+      27,    25,     0,    90,     0,     0,    72,    74,    81,    79,
+      80,    78,     0,     0,     0,    94,    95,     0,   118,   119,
+     120,   121,   122,   123,   124,   125,   126,   127,    97,     0,
+       0,    89,     0,     0,    82,    91,    92,    93,    43,     0,
+      84,     0,    88,    87,     0,    99,     0,    83,    90,     0,
+      85,     0,    86,    70,    71
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -154,  -154,  -154,  -154,  -154,  -154,  -154,  -154,   -70,  -154,
-    -154,   142,  -154,  -154,  -154,  -154,  -154,  -154,  -154,  -154,
-    -154,  -154,  -154,   -26,  -154,   -89,  -154,  -154,  -154,  -154,
-      64,  -153,   -42,   -21,  -154
+    -188,  -188,  -188,  -188,  -188,  -188,  -188,  -188,   -64,  -188,
+    -188,   118,  -188,  -188,  -188,  -188,  -188,  -188,  -188,  -188,
+    -188,  -188,  -188,  -188,  -188,  -188,  -188,   -44,  -188,  -130,
+    -188,  -188,  -188,  -188,  -188,  -188,  -188,    56,  -187,   -88,
+     -37,  -188
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_uint8 yydefgoto[] =
 {
        0,     1,     2,    13,    14,    15,    39,    16,    17,    42,
-      99,   100,    18,    29,    30,    31,    19,   118,    32,    33,
-      34,    70,   235,    44,   107,   108,   109,   110,   111,   112,
-     202,   113,    93,    94,    95
+      98,    99,    18,    29,    30,    43,    31,    44,    19,   108,
+      32,    71,    33,    34,   104,    69,   242,   102,   149,   150,
+     151,   234,   152,   153,   241,   154,   155,   220,   156,    92,
+      93,    94
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -793,103 +819,103 @@ static const yytype_uint8 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      45,   114,   203,   117,     3,   102,   103,    72,   104,   105,
-      97,   102,   103,   151,   104,   105,    20,    96,   159,   152,
-     101,   102,   103,    21,   104,   105,   135,   136,   137,   138,
-     139,   140,   141,   142,   143,   144,   145,   146,   147,   106,
-     148,   149,   135,   136,   115,   158,   168,   135,   136,   137,
-     138,    22,    98,   141,    43,   119,   102,   103,    24,   104,
-     105,    23,   135,   136,    37,   114,   130,   131,   141,    38,
-      35,   135,   136,   137,   138,   139,   140,   141,   203,    92,
-     144,   145,   135,    -1,    36,    92,   135,   136,   137,   138,
-     139,   140,   141,    40,   132,    92,   145,    41,   133,   172,
-     173,   174,   175,   176,   177,   178,   179,   180,   181,    43,
-      71,   182,    73,   114,   184,   185,   186,   187,   188,   189,
-     190,   191,   192,   193,   194,   195,   196,   197,   198,   199,
-      92,   134,   227,   201,   116,   204,   205,    25,    26,    27,
-      28,   232,   206,   207,   208,   237,   120,   150,   121,   122,
-     135,   136,   137,   138,   139,   140,   141,   142,   143,   144,
-     145,   146,   147,   123,   148,   149,   160,   124,   125,    74,
-      75,   135,   136,   137,   138,   139,   140,   141,   126,   114,
-     135,   136,   137,   138,   127,   140,   141,   128,   114,   114,
-     135,   136,   114,   138,   129,    76,   141,   154,   155,   156,
-     157,   228,     7,     8,     9,    10,    11,   161,   236,    77,
-      78,    79,    80,    81,    82,    83,    84,    85,    86,   171,
-     162,   170,   169,   183,    87,   163,   164,   165,   166,   167,
-      -1,    98,    88,    92,   209,    89,    90,    91,    92,   210,
-     222,   225,   135,   136,   137,   138,   139,   140,   141,   142,
-     143,   144,   145,   146,   147,   211,   148,   149,   226,   230,
-     229,   234,   135,   136,   137,   138,   139,   140,   141,   142,
-     143,   144,   145,   146,   147,   212,   148,   149,   135,   136,
-     137,   138,   139,   140,   141,   142,   143,   144,   145,   146,
-     147,   213,   148,   149,   200,   233,     0,     0,   135,   136,
-     137,   138,   139,   140,   141,   142,   143,   144,   145,   146,
-     147,   214,   148,   149,   135,   136,   137,   138,   139,   140,
-     141,   142,   143,   144,   145,   146,   147,   215,   148,   149,
-       0,     0,     0,     0,   135,   136,   137,   138,   139,   140,
-     141,   142,   143,   144,   145,   146,   147,   216,   148,   149,
-     135,   136,   137,   138,   139,   140,   141,   142,   143,   144,
-     145,   146,   147,   217,   148,   149,     0,     0,     0,     0,
-     135,   136,   137,   138,   139,   140,   141,   142,   143,   144,
-     145,   146,   147,   218,   148,   149,   135,   136,   137,   138,
-     139,   140,   141,   142,   143,   144,   145,   146,   147,   219,
-     148,   149,     0,     0,     0,     0,   135,   136,   137,   138,
-     139,   140,   141,   142,   143,   144,   145,   146,   147,   221,
-     148,   149,   135,   136,   137,   138,   139,   140,   141,   142,
-     143,   144,   145,   146,   147,   223,   148,   149,     0,     0,
-       0,     0,   135,   136,   137,   138,   139,   140,   141,   142,
-     143,   144,   145,   146,   147,   224,   148,   149,   135,   136,
-     137,   138,   139,   140,   141,   142,   143,   144,   145,   146,
-     147,     0,   148,   149,     0,   153,     0,     0,   135,   136,
-     137,   138,   139,   140,   141,   142,   143,   144,   145,   146,
-     147,   220,   148,   149,   135,   136,   137,   138,   139,   140,
-     141,   142,   143,   144,   145,   146,   147,     0,   148,   149,
-     135,   136,   137,   138,   139,   140,   141,   142,   143,   144,
-     145,   146,   147,   231,   148,   149,   135,   136,   137,   138,
-     139,   140,   141,   142,   143,   144,   145,   146,   147,     0,
-     148,   135,   136,   137,   138,   139,   140,   141,   142,   143,
-     144,   145,   146,   147,     0,   148,   149,    46,    47,    48,
-      49,    50,    51,    52,    53,    54,    55,    56,    57,    58,
-      59,    60,    61,    62,    63,    64,    65,    66,    67,    68,
-      69,   135,   136,   137,   138,   139,   140,   141,   142,   143,
-     144,   145,   146,   147,   135,   136,   137,   138,   139,   140,
-     141,   142,   143,   144,   145,     0,   147,   135,   136,   137,
-     138,   139,   140,   141,   142,   143,   144,   145,     4,     5,
-       6,     7,     8,     9,    10,    11,    12
+     103,    95,    37,   141,   100,     3,   221,    38,   107,   142,
+     122,    20,    96,   157,   123,   125,   126,   127,   128,   197,
+     130,   131,   198,   125,   126,   127,   128,   106,    21,   131,
+      40,    22,   144,   145,    41,   146,   147,    23,   109,   144,
+     145,   159,   146,   147,   144,   145,    35,   146,   147,   120,
+     121,   221,   144,   145,    97,   146,   147,   125,   126,    24,
+     158,   157,   125,   126,   157,   128,   148,    36,   131,   125,
+      -1,    70,   101,   163,   164,   165,   166,   167,   168,   169,
+     170,   171,   172,   101,   160,   173,   196,    72,   175,   176,
+     177,   178,   179,   180,   181,   182,   183,   184,   185,   186,
+     187,   188,   189,   190,   237,   157,    91,   105,   125,   126,
+     110,   244,   111,    91,   131,   112,   113,   114,    91,   125,
+     126,   127,   128,   129,   130,   131,    91,   115,   134,   135,
+     116,   117,   118,    73,    74,   125,   126,   127,   128,   129,
+     130,   131,   132,   133,   134,   135,   157,   137,   119,   140,
+     157,   161,   174,   157,   192,   219,    97,   222,   223,    75,
+       7,     8,     9,    10,    11,   225,   226,   227,    25,    26,
+      27,    28,   193,    76,    77,    78,    79,    80,    81,    82,
+      83,    84,    85,   162,   194,   195,   207,   199,    86,   202,
+     203,   204,   205,   206,   236,   200,    87,   243,   201,    88,
+      89,    90,    91,   208,    91,   224,   125,   126,   127,   128,
+     129,   130,   131,   132,   133,   134,   135,   136,   137,   209,
+     138,   139,    -1,   228,   229,   231,   125,   126,   127,   128,
+     129,   130,   131,   132,   133,   134,   135,   136,   137,   210,
+     138,   139,   125,   126,   127,   128,   129,   130,   131,   132,
+     133,   134,   135,   136,   137,   211,   138,   139,   235,   240,
+     191,     0,   125,   126,   127,   128,   129,   130,   131,   132,
+     133,   134,   135,   136,   137,   212,   138,   139,   125,   126,
+     127,   128,   129,   130,   131,   132,   133,   134,   135,   136,
+     137,   213,   138,   139,   239,     0,     0,     0,   125,   126,
+     127,   128,   129,   130,   131,   132,   133,   134,   135,   136,
+     137,   214,   138,   139,   125,   126,   127,   128,   129,   130,
+     131,   132,   133,   134,   135,   136,   137,   215,   138,   139,
+       0,     0,     0,     0,   125,   126,   127,   128,   129,   130,
+     131,   132,   133,   134,   135,   136,   137,   216,   138,   139,
+     125,   126,   127,   128,   129,   130,   131,   132,   133,   134,
+     135,   136,   137,   217,   138,   139,     0,     0,     0,     0,
+     125,   126,   127,   128,   129,   130,   131,   132,   133,   134,
+     135,   136,   137,   230,   138,   139,   125,   126,   127,   128,
+     129,   130,   131,   132,   133,   134,   135,   136,   137,   232,
+     138,   139,     0,     0,     0,     0,   125,   126,   127,   128,
+     129,   130,   131,   132,   133,   134,   135,   136,   137,   233,
+     138,   139,   125,   126,   127,   128,   129,   130,   131,   132,
+     133,   134,   135,   136,   137,     0,   138,   139,     0,   124,
+       0,     0,   125,   126,   127,   128,   129,   130,   131,   132,
+     133,   134,   135,   136,   137,   143,   138,   139,   125,   126,
+     127,   128,   129,   130,   131,   132,   133,   134,   135,   136,
+     137,   218,   138,   139,   125,   126,   127,   128,   129,   130,
+     131,   132,   133,   134,   135,   136,   137,     0,   138,   139,
+     125,   126,   127,   128,   129,   130,   131,   132,   133,   134,
+     135,   136,   137,   238,   138,   139,   125,   126,   127,   128,
+     129,   130,   131,   132,   133,   134,   135,   136,   137,     0,
+     138,   125,   126,   127,   128,   129,   130,   131,   132,   133,
+     134,   135,   136,   137,     0,   138,   139,    45,    46,    47,
+      48,    49,    50,    51,    52,    53,    54,    55,    56,    57,
+      58,    59,    60,    61,    62,    63,    64,    65,    66,    67,
+      68,   125,   126,   127,   128,   129,   130,   131,   132,   133,
+     134,   135,   136,   137,     0,   138,   139,   125,   126,   127,
+     128,   129,   130,   131,   132,   133,   134,   135,   136,   137,
+     125,   126,   127,   128,   129,   130,   131,   132,   133,   134,
+     135,   125,   126,   127,   128,   129,   130,   131,     0,     0,
+       0,   135,     4,     5,     6,     7,     8,     9,    10,    11,
+      12,   125,   126,   127,   128,   129,   130,   131
 };
 
 static const yytype_int16 yycheck[] =
 {
-      26,    43,   155,    73,     0,    16,    17,    33,    19,    20,
-      48,    16,    17,    48,    19,    20,    15,    38,   107,    54,
-      41,    16,    17,    53,    19,    20,    71,    72,    73,    74,
-      75,    76,    77,    78,    79,    80,    81,    82,    83,    50,
-      85,    86,    71,    72,    70,    50,   116,    71,    72,    73,
-      74,    90,    90,    77,    49,    76,    16,    17,    90,    19,
-      20,    53,    71,    72,    51,   107,    87,    88,    77,    56,
-      53,    71,    72,    73,    74,    75,    76,    77,   231,    90,
-      80,    81,    71,    72,    90,    90,    71,    72,    73,    74,
-      75,    76,    77,    47,    51,    90,    81,    51,    55,   120,
-     121,   122,   123,   124,   125,   126,   127,   128,   129,    49,
-      90,   132,    47,   155,   135,   136,   137,   138,   139,   140,
-     141,   142,   143,   144,   145,   146,   147,   148,   149,   150,
-      90,    52,   221,   154,    47,   156,   157,    12,    13,    14,
-      15,   230,   163,   164,   165,   234,    47,    56,    47,    47,
-      71,    72,    73,    74,    75,    76,    77,    78,    79,    80,
-      81,    82,    83,    47,    85,    86,    53,    47,    47,    21,
-      22,    71,    72,    73,    74,    75,    76,    77,    47,   221,
-      71,    72,    73,    74,    47,    76,    77,    47,   230,   231,
-      71,    72,   234,    74,    47,    47,    77,    47,    47,    47,
-      47,   222,     6,     7,     8,     9,    10,    53,   234,    61,
-      62,    63,    64,    65,    66,    67,    68,    69,    70,    48,
-      53,    48,    90,    90,    76,    56,    57,    58,    59,    60,
-      71,    90,    84,    90,    90,    87,    88,    89,    90,    48,
-      53,    48,    71,    72,    73,    74,    75,    76,    77,    78,
-      79,    80,    81,    82,    83,    48,    85,    86,    55,    18,
-      90,    48,    71,    72,    73,    74,    75,    76,    77,    78,
+      44,    38,    51,    48,    41,     0,   193,    56,    72,    54,
+      51,    15,    48,   101,    55,    71,    72,    73,    74,   149,
+      76,    77,   152,    71,    72,    73,    74,    71,    53,    77,
+      47,    90,    16,    17,    51,    19,    20,    53,    75,    16,
+      17,   105,    19,    20,    16,    17,    53,    19,    20,    86,
+      87,   238,    16,    17,    90,    19,    20,    71,    72,    90,
+     104,   149,    71,    72,   152,    74,    50,    90,    77,    71,
+      72,    90,    49,   110,   111,   112,   113,   114,   115,   116,
+     117,   118,   119,    49,    90,   122,    50,    47,   125,   126,
+     127,   128,   129,   130,   131,   132,   133,   134,   135,   136,
+     137,   138,   139,   140,   234,   193,    90,    47,    71,    72,
+      47,   241,    47,    90,    77,    47,    47,    47,    90,    71,
+      72,    73,    74,    75,    76,    77,    90,    47,    80,    81,
+      47,    47,    47,    21,    22,    71,    72,    73,    74,    75,
+      76,    77,    78,    79,    80,    81,   234,    83,    47,    56,
+     238,    48,    90,   241,    47,   192,    90,   194,   195,    47,
+       6,     7,     8,     9,    10,   202,   203,   204,    12,    13,
+      14,    15,    47,    61,    62,    63,    64,    65,    66,    67,
+      68,    69,    70,    48,    47,    47,    90,    53,    76,    56,
+      57,    58,    59,    60,   231,    53,    84,   241,    53,    87,
+      88,    89,    90,    48,    90,    18,    71,    72,    73,    74,
+      75,    76,    77,    78,    79,    80,    81,    82,    83,    48,
+      85,    86,    71,    48,    55,    53,    71,    72,    73,    74,
+      75,    76,    77,    78,    79,    80,    81,    82,    83,    48,
+      85,    86,    71,    72,    73,    74,    75,    76,    77,    78,
+      79,    80,    81,    82,    83,    48,    85,    86,    90,    48,
+     142,    -1,    71,    72,    73,    74,    75,    76,    77,    78,
       79,    80,    81,    82,    83,    48,    85,    86,    71,    72,
       73,    74,    75,    76,    77,    78,    79,    80,    81,    82,
-      83,    48,    85,    86,   152,   231,    -1,    -1,    71,    72,
+      83,    48,    85,    86,   238,    -1,    -1,    -1,    71,    72,
       73,    74,    75,    76,    77,    78,    79,    80,    81,    82,
       83,    48,    85,    86,    71,    72,    73,    74,    75,    76,
       77,    78,    79,    80,    81,    82,    83,    48,    85,    86,
@@ -903,11 +929,9 @@ static const yytype_int16 yycheck[] =
       85,    86,    -1,    -1,    -1,    -1,    71,    72,    73,    74,
       75,    76,    77,    78,    79,    80,    81,    82,    83,    48,
       85,    86,    71,    72,    73,    74,    75,    76,    77,    78,
-      79,    80,    81,    82,    83,    48,    85,    86,    -1,    -1,
+      79,    80,    81,    82,    83,    -1,    85,    86,    -1,    52,
       -1,    -1,    71,    72,    73,    74,    75,    76,    77,    78,
-      79,    80,    81,    82,    83,    48,    85,    86,    71,    72,
-      73,    74,    75,    76,    77,    78,    79,    80,    81,    82,
-      83,    -1,    85,    86,    -1,    52,    -1,    -1,    71,    72,
+      79,    80,    81,    82,    83,    52,    85,    86,    71,    72,
       73,    74,    75,    76,    77,    78,    79,    80,    81,    82,
       83,    52,    85,    86,    71,    72,    73,    74,    75,    76,
       77,    78,    79,    80,    81,    82,    83,    -1,    85,    86,
@@ -919,10 +943,12 @@ static const yytype_int16 yycheck[] =
       26,    27,    28,    29,    30,    31,    32,    33,    34,    35,
       36,    37,    38,    39,    40,    41,    42,    43,    44,    45,
       46,    71,    72,    73,    74,    75,    76,    77,    78,    79,
-      80,    81,    82,    83,    71,    72,    73,    74,    75,    76,
-      77,    78,    79,    80,    81,    -1,    83,    71,    72,    73,
-      74,    75,    76,    77,    78,    79,    80,    81,     3,     4,
-       5,     6,     7,     8,     9,    10,    11
+      80,    81,    82,    83,    -1,    85,    86,    71,    72,    73,
+      74,    75,    76,    77,    78,    79,    80,    81,    82,    83,
+      71,    72,    73,    74,    75,    76,    77,    78,    79,    80,
+      81,    71,    72,    73,    74,    75,    76,    77,    -1,    -1,
+      -1,    81,     3,     4,     5,     6,     7,     8,     9,    10,
+      11,    71,    72,    73,    74,    75,    76,    77
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
@@ -930,29 +956,30 @@ static const yytype_int16 yycheck[] =
 static const yytype_uint8 yystos[] =
 {
        0,    96,    97,     0,     3,     4,     5,     6,     7,     8,
-       9,    10,    11,    98,    99,   100,   102,   103,   107,   111,
+       9,    10,    11,    98,    99,   100,   102,   103,   107,   113,
       15,    53,    90,    53,    90,    12,    13,    14,    15,   108,
-     109,   110,   113,   114,   115,    53,    90,    51,    56,   101,
-      47,    51,   104,    49,   118,   118,    23,    24,    25,    26,
-      27,    28,    29,    30,    31,    32,    33,    34,    35,    36,
-      37,    38,    39,    40,    41,    42,    43,    44,    45,    46,
-     116,    90,   118,    47,    21,    22,    47,    61,    62,    63,
-      64,    65,    66,    67,    68,    69,    70,    76,    84,    87,
-      88,    89,    90,   127,   128,   129,   128,    48,    90,   105,
-     106,   128,    16,    17,    19,    20,    50,   119,   120,   121,
-     122,   123,   124,   126,   127,   118,    47,   103,   112,   128,
+     109,   111,   115,   117,   118,    53,    90,    51,    56,   101,
+      47,    51,   104,   110,   112,    23,    24,    25,    26,    27,
+      28,    29,    30,    31,    32,    33,    34,    35,    36,    37,
+      38,    39,    40,    41,    42,    43,    44,    45,    46,   120,
+      90,   116,    47,    21,    22,    47,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    76,    84,    87,    88,
+      89,    90,   134,   135,   136,   135,    48,    90,   105,   106,
+     135,    49,   122,   122,   119,    47,   122,   103,   114,   135,
       47,    47,    47,    47,    47,    47,    47,    47,    47,    47,
-     128,   128,    51,    55,    52,    71,    72,    73,    74,    75,
+     135,   135,    51,    55,    52,    71,    72,    73,    74,    75,
       76,    77,    78,    79,    80,    81,    82,    83,    85,    86,
-      56,    48,    54,    52,    47,    47,    47,    47,    50,   120,
-      53,    53,    53,    56,    57,    58,    59,    60,   103,    90,
-      48,    48,   128,   128,   128,   128,   128,   128,   128,   128,
-     128,   128,   128,    90,   128,   128,   128,   128,   128,   128,
-     128,   128,   128,   128,   128,   128,   128,   128,   128,   128,
-     106,   128,   125,   126,   128,   128,   128,   128,   128,    90,
-      48,    48,    48,    48,    48,    48,    48,    48,    48,    48,
-      52,    48,    53,    48,    48,    48,    55,   120,   128,    90,
-      18,    53,   120,   125,    48,   117,   118,   120
+      56,    48,    54,    52,    16,    17,    19,    20,    50,   123,
+     124,   125,   127,   128,   130,   131,   133,   134,   122,   103,
+      90,    48,    48,   135,   135,   135,   135,   135,   135,   135,
+     135,   135,   135,   135,    90,   135,   135,   135,   135,   135,
+     135,   135,   135,   135,   135,   135,   135,   135,   135,   135,
+     135,   106,    47,    47,    47,    47,    50,   124,   124,    53,
+      53,    53,    56,    57,    58,    59,    60,    90,    48,    48,
+      48,    48,    48,    48,    48,    48,    48,    48,    52,   135,
+     132,   133,   135,   135,    18,   135,   135,   135,    48,    55,
+      48,    53,    48,    48,   126,    90,   135,   124,    53,   132,
+      48,   129,   121,   122,   124
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
@@ -961,16 +988,17 @@ static const yytype_uint8 yyr1[] =
        0,    95,    96,    97,    97,    98,    98,    98,    99,    99,
      100,   100,   100,   101,   101,   102,   102,   103,   103,   103,
      103,   103,   104,   104,   104,   105,   105,   106,   107,   107,
-     108,   108,   108,   108,   109,   110,   111,   112,   112,   113,
-     114,   115,   116,   116,   116,   116,   116,   116,   116,   116,
-     116,   116,   116,   116,   116,   116,   116,   116,   116,   116,
-     116,   116,   116,   116,   116,   116,   117,   117,   118,   118,
-     119,   119,   120,   120,   120,   120,   120,   121,   121,   122,
-     123,   124,   125,   125,   126,   126,   126,   126,   126,   127,
-     127,   127,   127,   128,   128,   128,   128,   128,   128,   128,
-     128,   128,   128,   128,   128,   128,   128,   128,   128,   128,
-     128,   129,   129,   129,   129,   129,   129,   129,   129,   129,
-     129,   129,   129,   129,   129,   129,   129,   129
+     108,   108,   108,   108,   110,   109,   112,   111,   113,   114,
+     114,   116,   115,   117,   119,   118,   120,   120,   120,   120,
+     120,   120,   120,   120,   120,   120,   120,   120,   120,   120,
+     120,   120,   120,   120,   120,   120,   120,   120,   120,   120,
+     121,   121,   122,   122,   123,   123,   124,   124,   124,   124,
+     124,   125,   126,   125,   127,   129,   128,   130,   131,   132,
+     132,   133,   133,   133,   133,   133,   134,   134,   134,   134,
+     135,   135,   135,   135,   135,   135,   135,   135,   135,   135,
+     135,   135,   135,   135,   135,   135,   135,   135,   136,   136,
+     136,   136,   136,   136,   136,   136,   136,   136,   136,   136,
+     136,   136,   136,   136,   136
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
@@ -979,16 +1007,17 @@ static const yytype_int8 yyr2[] =
        0,     2,     2,     2,     0,     2,     2,     2,     3,     5,
        1,     1,     1,     2,     0,     3,     5,     1,     1,     1,
        1,     1,     3,     2,     0,     3,     1,     3,     2,     0,
-       1,     1,     1,     1,     2,     2,     6,     2,     1,     2,
-       6,     3,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     0,     3,     0,     3,     6,     2,
+       1,     0,     3,     6,     0,     4,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     1,     1,     1,     3,     2,
-       2,     1,     1,     1,     2,     2,     2,     5,     7,     9,
-       4,     4,     1,     0,     3,     3,     3,     2,     2,     1,
-       4,     3,     6,     1,     3,     3,     3,     3,     3,     3,
-       3,     3,     3,     3,     3,     3,     3,     2,     2,     3,
-       3,     4,     4,     4,     4,     4,     4,     4,     4,     4,
-       4,     3,     1,     1,     1,     1,     1,     1
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     3,     2,     2,     1,     1,     1,     2,     2,
+       2,     2,     0,     5,     4,     0,    10,     4,     4,     1,
+       0,     3,     3,     3,     2,     2,     1,     4,     3,     6,
+       1,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     2,     2,     3,     3,     4,     4,
+       4,     4,     4,     4,     4,     4,     4,     4,     3,     1,
+       1,     1,     1,     1,     1
 };
 
 
@@ -1456,35 +1485,7 @@ yydestruct (const char *yymsg,
   YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  switch (yykind)
-    {
-    case YYSYMBOL_T_EXIT: /* "exit"  */
-#line 41 "gpl.y"
-            { delete ((*yyvaluep).union_string); }
-#line 1465 "gpl.tab.c"
-        break;
-
-    case YYSYMBOL_T_PRINT: /* "print"  */
-#line 41 "gpl.y"
-            { delete ((*yyvaluep).union_string); }
-#line 1471 "gpl.tab.c"
-        break;
-
-    case YYSYMBOL_T_STRING_CONSTANT: /* "string constant"  */
-#line 41 "gpl.y"
-            { delete ((*yyvaluep).union_string); }
-#line 1477 "gpl.tab.c"
-        break;
-
-    case YYSYMBOL_T_ID: /* "identifier"  */
-#line 41 "gpl.y"
-            { delete ((*yyvaluep).union_string); }
-#line 1483 "gpl.tab.c"
-        break;
-
-      default:
-        break;
-    }
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -1750,305 +1751,410 @@ yyreduce:
   switch (yyn)
     {
   case 8: /* variable_declaration: simple_type "identifier" optional_initializer  */
-#line 195 "gpl.y"
+#line 214 "gpl.y"
                                           {
-        if (!(yyvsp[-1].union_string)) { YYERROR; }
-        if(sm.defined_in_current_scope(*(yyvsp[-1].union_string))) {
-            gamelang::error(gamelang::PREVIOUSLY_DECLARED_VARIABLE,*(yyvsp[-1].union_string));
-            delete (yyvsp[-1].union_string);
+        if(sm.defined_in_current_scope((yyvsp[-1].union_id))) {
+            gamelang::error(gamelang::PREVIOUSLY_DECLARED_VARIABLE,identifiers.name((yyvsp[-1].union_id)));
             break;
         }
 
-        Symbol* symbol = nullptr;
-        try {
-            if ((yyvsp[-2].union_gpl_type) == gamelang::INT) {
-                int val = 0;
-                if ((yyvsp[0].union_expression_ptr) != nullptr) {
-                    if (auto var_expr = dynamic_cast<const Variable*>((yyvsp[0].union_expression_ptr))) {
-                        Symbol* init_sym = sm.lookup(var_expr->get_symbol_name());
-                        if (init_sym && init_sym->get_count() > 1
-                            && var_expr->is_whole_array_reference())
-                        {
-                            gamelang::error(gamelang::VARIABLE_IS_AN_ARRAY, init_sym->get_name());
-                            delete (yyvsp[-1].union_string); delete (yyvsp[0].union_expression_ptr); break;
-                        }
-                    }
-
-                    std::unique_ptr<const Constant> constant((yyvsp[0].union_expression_ptr)->evaluate());
-                    if (constant == nullptr) {
-                        delete (yyvsp[-1].union_string);
-                        delete (yyvsp[0].union_expression_ptr);
-                        break;
-                    }
-
-                    gamelang::Type actual_type = constant->type();
-                    if (actual_type != gamelang::INT) {
-                        throw actual_type;
-                    }
-                    val = constant->as_int();
-                    delete (yyvsp[0].union_expression_ptr);
+        Constant_ptr constant;
+        if ((yyvsp[0].union_expression_ptr) != nullptr) {
+            if (auto var_expr = dynamic_cast<const Variable*>((yyvsp[0].union_expression_ptr))) {
+                const Symbol* init_sym = var_expr->get_symbol();
+                if (init_sym && init_sym->get_count() > 1
+                    && var_expr->is_whole_array_reference())
+                {
+                    gamelang::error(gamelang::VARIABLE_IS_AN_ARRAY, init_sym->get_name());
+                    Expression::destroy((yyvsp[0].union_expression_ptr)); break;
                 }
-                symbol = new Symbol(*(yyvsp[-1].union_string), new int(val));
             }
-            else if ((yyvsp[-2].union_gpl_type) == gamelang::DOUBLE) {
-                double val = 0.0;
-                if ((yyvsp[0].union_expression_ptr) != nullptr) {
-                    if (auto var_expr = dynamic_cast<const Variable*>((yyvsp[0].union_expression_ptr))) {
-                        Symbol* init_sym = sm.lookup(var_expr->get_symbol_name());
-                        if (init_sym && init_sym->get_count() > 1
-                            && var_expr->is_whole_array_reference())
-                        {
-                            gamelang::error(gamelang::VARIABLE_IS_AN_ARRAY, init_sym->get_name());
-                            delete (yyvsp[-1].union_string); delete (yyvsp[0].union_expression_ptr); break;
-                        }
-                    }
 
-                    std::unique_ptr<const Constant> constant((yyvsp[0].union_expression_ptr)->evaluate());
-                    if (constant == nullptr) {
-                        delete (yyvsp[-1].union_string);
-                        delete (yyvsp[0].union_expression_ptr);
-                        break;
-                    }
+            constant = (yyvsp[0].union_expression_ptr)->evaluate();
+            gamelang::Type actual_type = (yyvsp[0].union_expression_ptr)->type();
+            Expression::destroy((yyvsp[0].union_expression_ptr));
+            if (constant == nullptr)
+                break;
 
-                    gamelang::Type actual_type = constant->type();
-                    if (actual_type != gamelang::DOUBLE &&
-                        actual_type != gamelang::INT) {
-                        throw actual_type;
-                    }
-                    val = constant->as_double();
-                    delete (yyvsp[0].union_expression_ptr);
-                }
-                symbol = new Symbol(*(yyvsp[-1].union_string), new double(val));
-            }
-            else if ((yyvsp[-2].union_gpl_type) == gamelang::STRING) {
-                std::string val = "";
-                if ((yyvsp[0].union_expression_ptr) != nullptr) {
-                    if (auto var_expr = dynamic_cast<const Variable*>((yyvsp[0].union_expression_ptr))) {
-                        Symbol* init_sym = sm.lookup(var_expr->get_symbol_name());
-                        if (init_sym && init_sym->get_count() > 1
-                            && var_expr->is_whole_array_reference())
-                        {
-                            gamelang::error(gamelang::VARIABLE_IS_AN_ARRAY, init_sym->get_name());
-                            delete (yyvsp[-1].union_string); delete (yyvsp[0].union_expression_ptr); break;
-                        }
-                    }
-
-                    std::unique_ptr<const Constant> constant((yyvsp[0].union_expression_ptr)->evaluate());
-                    if (constant == nullptr) {
-                        delete (yyvsp[-1].union_string);
-                        delete (yyvsp[0].union_expression_ptr);
-                        break;
-                    }
-
-                    val = constant->as_string();
-                    delete (yyvsp[0].union_expression_ptr);
-                }
-                symbol = new Symbol(*(yyvsp[-1].union_string), new std::string(val));
+            // checked from the static type, then from the value's own
+            // type, so the accessors below cannot fail
+            if (gamelang::converts_to(actual_type, (yyvsp[-2].union_gpl_type)))
+                actual_type = constant->type();
+            if (!gamelang::converts_to(actual_type, (yyvsp[-2].union_gpl_type))) {
+                gamelang::error(gamelang::INVALID_TYPE_FOR_INITIAL_VALUE, gamelang::to_string(actual_type),
+                                identifiers.name((yyvsp[-1].union_id)), gamelang::to_string((yyvsp[-2].union_gpl_type)));
+                break;
             }
         }
-        catch (gamelang::Type actual_type) {
-            std::string expected = gamelang::to_string((yyvsp[-2].union_gpl_type));
-            std::string actual = gamelang::to_string(actual_type);
-            gamelang::error(gamelang::INVALID_TYPE_FOR_INITIAL_VALUE, actual, *(yyvsp[-1].union_string), expected);
-            delete (yyvsp[-1].union_string);
-            if ((yyvsp[0].union_expression_ptr) != nullptr) delete (yyvsp[0].union_expression_ptr);
-            break;
-        }
 
+        Symbol* symbol;
+        if ((yyvsp[-2].union_gpl_type) == gamelang::INT)
+            symbol = new Symbol((yyvsp[-1].union_id), constant ? constant->as_int() : 0);
+        else if ((yyvsp[-2].union_gpl_type) == gamelang::DOUBLE)
+            symbol = new Symbol((yyvsp[-1].union_id), constant ? constant->as_double() : 0.0);
+        else
+            symbol = new Symbol((yyvsp[-1].union_id), constant ? constant->as_string() : std::string());
         sm.add_to_current_scope(symbol);
-        delete (yyvsp[-1].union_string);
     }
-#line 1862 "gpl.tab.c"
+#line 1800 "gpl.tab.c"
     break;
 
   case 9: /* variable_declaration: simple_type "identifier" "[" expression "]"  */
-#line 302 "gpl.y"
+#line 258 "gpl.y"
                                                         {
-        if (sm.defined_in_current_scope(*(yyvsp[-3].union_string))) {
-            gamelang::error(gamelang::PREVIOUSLY_DECLARED_VARIABLE, *(yyvsp[-3].union_string));
-            delete (yyvsp[-3].union_string);
-            delete (yyvsp[-1].union_expression_ptr);
+        if (sm.defined_in_current_scope((yyvsp[-3].union_id))) {
+            gamelang::error(gamelang::PREVIOUSLY_DECLARED_VARIABLE, identifiers.name((yyvsp[-3].union_id)));
+            Expression::destroy((yyvsp[-1].union_expression_ptr));
             break;
         }
 
-        std::unique_ptr<const Constant> size_constant((yyvsp[-1].union_expression_ptr)->evaluate());
+        Constant_ptr size_constant = (yyvsp[-1].union_expression_ptr)->evaluate();
         gamelang::Type size_type = size_constant ? size_constant->type() : gamelang::NO_TYPE;
 
         if (size_constant == nullptr) {
-            delete (yyvsp[-3].union_string);
-            delete (yyvsp[-1].union_expression_ptr);
+            Expression::destroy((yyvsp[-1].union_expression_ptr));
             break;
         }
         if (size_type != gamelang::INT) {
             gamelang::error(gamelang::ARRAY_SIZE_MUST_BE_AN_INTEGER,
-                            gamelang::to_string(size_type), *(yyvsp[-3].union_string));
-            delete (yyvsp[-3].union_string);
-            delete (yyvsp[-1].union_expression_ptr);
+                            gamelang::to_string(size_type), identifiers.name((yyvsp[-3].union_id)));
+            Expression::destroy((yyvsp[-1].union_expression_ptr));
             break;
         }
 
         int size = size_constant->as_int();
         if (size < 1) {
-            gamelang::error(gamelang::INVALID_ARRAY_SIZE, *(yyvsp[-3].union_string), std::to_string(size));
-            delete (yyvsp[-3].union_string);
-            delete (yyvsp[-1].union_expression_ptr);
+            gamelang::error(gamelang::INVALID_ARRAY_SIZE, identifiers.name((yyvsp[-3].union_id)), std::to_string(size));
+            Expression::destroy((yyvsp[-1].union_expression_ptr));
             break;
         }
 
-        Symbol* sym = nullptr;
-        if ((yyvsp[-4].union_gpl_type) == gamelang::INT) {
-            int* arr = new int[size];
-            for (int i = 0; i < size; i++) arr[i] = i;
-            sym = new Symbol(*(yyvsp[-3].union_string), arr, size);
-        }
-        else if ((yyvsp[-4].union_gpl_type) == gamelang::DOUBLE) {
-            double* arr = new double[size];
-            for (int i = 0; i < size; i++) arr[i] = i + 0.5;
-            sym = new Symbol(*(yyvsp[-3].union_string), arr, size);
-        }
-        else if ((yyvsp[-4].union_gpl_type) == gamelang::STRING) {
-            std::string* arr = new std::string[size];
-            for (int i = 0; i < size; i++) arr[i] = std::to_string(i);
-            sym = new Symbol(*(yyvsp[-3].union_string), arr, size);
-        }
-        sm.add_to_current_scope(sym);
-        delete (yyvsp[-3].union_string);
-        delete (yyvsp[-1].union_expression_ptr);
+        // element i starts as i, i + 0.5 or "i"
+        sm.add_to_current_scope(new Symbol((yyvsp[-3].union_id), (yyvsp[-4].union_gpl_type), size, Symbol_storage::INDEX));
+        Expression::destroy((yyvsp[-1].union_expression_ptr));
     }
-#line 1919 "gpl.tab.c"
+#line 1837 "gpl.tab.c"
     break;
 
   case 10: /* simple_type: "int"  */
-#line 358 "gpl.y"
+#line 294 "gpl.y"
                {(yyval.union_gpl_type)=gamelang::INT;}
-#line 1925 "gpl.tab.c"
+#line 1843 "gpl.tab.c"
     break;
 
   case 11: /* simple_type: "double"  */
-#line 359 "gpl.y"
+#line 295 "gpl.y"
                {(yyval.union_gpl_type)=gamelang::DOUBLE;}
-#line 1931 "gpl.tab.c"
+#line 1849 "gpl.tab.c"
     break;
 
   case 12: /* simple_type: "string"  */
-#line 360 "gpl.y"
+#line 296 "gpl.y"
                {(yyval.union_gpl_type)=gamelang::STRING;}
-#line 1937 "gpl.tab.c"
+#line 1855 "gpl.tab.c"
     break;
 
   case 13: /* optional_initializer: "=" expression  */
-#line 365 "gpl.y"
+#line 301 "gpl.y"
                         { (yyval.union_expression_ptr) = (yyvsp[0].union_expression_ptr); }
-#line 1943 "gpl.tab.c"
+#line 1861 "gpl.tab.c"
     break;
 
   case 14: /* optional_initializer: %empty  */
-#line 366 "gpl.y"
+#line 302 "gpl.y"
              { (yyval.union_expression_ptr) = nullptr; }
-#line 1949 "gpl.tab.c"
+#line 1867 "gpl.tab.c"
+    break;
+
+  case 34: /* $@1: %empty  */
+#line 354 "gpl.y"
+                     {
+        statement_builder.begin_block(Statement_block::INITIALIZATION);
+    }
+#line 1875 "gpl.tab.c"
+    break;
+
+  case 35: /* initialization_block: "initialization" $@1 statement_block  */
+#line 357 "gpl.y"
+                    {
+        statement_builder.end_block();
+    }
+#line 1883 "gpl.tab.c"
+    break;
+
+  case 36: /* $@2: %empty  */
+#line 364 "gpl.y"
+                  {
+        statement_builder.begin_block(Statement_block::TERMINATION);
+    }
+#line 1891 "gpl.tab.c"
+    break;
+
+  case 37: /* termination_block: "termination" $@2 statement_block  */
+#line 367 "gpl.y"
+                    {
+        statement_builder.end_block();
+    }
+#line 1899 "gpl.tab.c"
+    break;
+
+  case 41: /* $@3: %empty  */
+#line 385 "gpl.y"
+                          {
+        statement_builder.begin_block(Statement_block::ANIMATION);
+    }
+#line 1907 "gpl.tab.c"
+    break;
+
+  case 42: /* animation_block: animation_declaration $@3 statement_block  */
+#line 388 "gpl.y"
+                    {
+        statement_builder.end_block();
+    }
+#line 1915 "gpl.tab.c"
+    break;
+
+  case 44: /* $@4: %empty  */
+#line 400 "gpl.y"
+                   {
+        statement_builder.begin_block(Statement_block::ON);
+    }
+#line 1923 "gpl.tab.c"
+    break;
+
+  case 45: /* on_block: "on" keystroke $@4 statement_block  */
+#line 403 "gpl.y"
+                    {
+        statement_builder.end_block();
+    }
+#line 1931 "gpl.tab.c"
+    break;
+
+  case 78: /* statement: assign_statement ";"  */
+#line 459 "gpl.y"
+                               { statement_builder.assign((yyvsp[-1].union_assignment)); }
+#line 1937 "gpl.tab.c"
+    break;
+
+  case 81: /* if_statement: if_header statement  */
+#line 466 "gpl.y"
+                                         {
+        statement_builder.end_if((yyvsp[-1].union_int));
+    }
+#line 1945 "gpl.tab.c"
+    break;
+
+  case 82: /* @5: %empty  */
+#line 469 "gpl.y"
+                               {
+        (yyval.union_int) = statement_builder.begin_else((yyvsp[-2].union_int));
+    }
+#line 1953 "gpl.tab.c"
+    break;
+
+  case 83: /* if_statement: if_header statement "else" @5 statement  */
+#line 472 "gpl.y"
+              {
+        statement_builder.end_if((yyvsp[-1].union_int));
+    }
+#line 1961 "gpl.tab.c"
     break;
 
-  case 89: /* variable: "identifier"  */
-#line 546 "gpl.y"
+  case 84: /* if_header: "if" "(" expression ")"  */
+#line 479 "gpl.y"
+                                      {
+        (yyval.union_int) = statement_builder.begin_if((yyvsp[-1].union_expression_ptr));
+    }
+#line 1969 "gpl.tab.c"
+    break;
+
+  case 85: /* $@6: %empty  */
+#line 486 "gpl.y"
+                                                                                                           {
+        loop_bounds.enter_loop((yyvsp[-5].union_assignment), (yyvsp[-3].union_expression_ptr), (yyvsp[-1].union_assignment));
+        statement_builder.begin_for((yyvsp[-5].union_assignment), (yyvsp[-3].union_expression_ptr), (yyvsp[-1].union_assignment));
+    }
+#line 1978 "gpl.tab.c"
+    break;
+
+  case 86: /* for_statement: "for" "(" assign_statement_or_empty ";" expression ";" assign_statement_or_empty ")" $@6 statement_or_block_of_statements  */
+#line 490 "gpl.y"
+                                     {
+        loop_bounds.leave_loop();
+        statement_builder.end_for();
+    }
+#line 1987 "gpl.tab.c"
+    break;
+
+  case 87: /* print_statement: "print" "(" expression ")"  */
+#line 498 "gpl.y"
+                                         {
+        statement_builder.print((yyvsp[-1].union_expression_ptr), (yyvsp[-3].union_int));
+    }
+#line 1995 "gpl.tab.c"
+    break;
+
+  case 88: /* exit_statement: "exit" "(" expression ")"  */
+#line 505 "gpl.y"
+                                        {
+        statement_builder.exit((yyvsp[-1].union_expression_ptr), (yyvsp[-3].union_int));
+    }
+#line 2003 "gpl.tab.c"
+    break;
+
+  case 89: /* assign_statement_or_empty: assign_statement  */
+#line 512 "gpl.y"
+                     { (yyval.union_assignment) = (yyvsp[0].union_assignment); }
+#line 2009 "gpl.tab.c"
+    break;
+
+  case 90: /* assign_statement_or_empty: %empty  */
+#line 513 "gpl.y"
+             { (yyval.union_assignment) = Assignment_form{Assignment_form::NONE, nullptr, nullptr}; }
+#line 2015 "gpl.tab.c"
+    break;
+
+  case 91: /* assign_statement: variable "=" expression  */
+#line 518 "gpl.y"
+                                 {
+        (yyval.union_assignment) = Assignment_form{Assignment_form::ASSIGN, (yyvsp[-2].union_variable_ptr), (yyvsp[0].union_expression_ptr)};
+        loop_bounds.assigned((yyvsp[-2].union_variable_ptr));
+    }
+#line 2024 "gpl.tab.c"
+    break;
+
+  case 92: /* assign_statement: variable "+=" expression  */
+#line 522 "gpl.y"
+                                        {
+        (yyval.union_assignment) = Assignment_form{Assignment_form::PLUS_ASSIGN, (yyvsp[-2].union_variable_ptr), (yyvsp[0].union_expression_ptr)};
+        loop_bounds.assigned((yyvsp[-2].union_variable_ptr));
+    }
+#line 2033 "gpl.tab.c"
+    break;
+
+  case 93: /* assign_statement: variable "-=" expression  */
+#line 526 "gpl.y"
+                                         {
+        (yyval.union_assignment) = Assignment_form{Assignment_form::MINUS_ASSIGN, (yyvsp[-2].union_variable_ptr), (yyvsp[0].union_expression_ptr)};
+        loop_bounds.assigned((yyvsp[-2].union_variable_ptr));
+    }
+#line 2042 "gpl.tab.c"
+    break;
+
+  case 94: /* assign_statement: variable "++"  */
+#line 530 "gpl.y"
+                           {
+        (yyval.union_assignment) = Assignment_form{Assignment_form::PLUS_PLUS, (yyvsp[-1].union_variable_ptr), nullptr};
+        loop_bounds.assigned((yyvsp[-1].union_variable_ptr));
+    }
+#line 2051 "gpl.tab.c"
+    break;
+
+  case 95: /* assign_statement: variable "--"  */
+#line 534 "gpl.y"
+                             {
+        (yyval.union_assignment) = Assignment_form{Assignment_form::MINUS_MINUS, (yyvsp[-1].union_variable_ptr), nullptr};
+        loop_bounds.assigned((yyvsp[-1].union_variable_ptr));
+    }
+#line 2060 "gpl.tab.c"
+    break;
+
+  case 96: /* variable: "identifier"  */
+#line 542 "gpl.y"
         {
-    (yyval.union_variable_ptr) = new Variable(*(yyvsp[0].union_string)); // simple variable
-      delete (yyvsp[0].union_string);
+    (yyval.union_variable_ptr) = new Variable((yyvsp[0].union_id)); // simple variable
     }
-#line 1958 "gpl.tab.c"
+#line 2068 "gpl.tab.c"
     break;
 
-  case 90: /* variable: "identifier" "[" expression "]"  */
-#line 550 "gpl.y"
+  case 97: /* variable: "identifier" "[" expression "]"  */
+#line 545 "gpl.y"
                                            {
-        (yyval.union_variable_ptr) = new Variable(*(yyvsp[-3].union_string), (yyvsp[-1].union_expression_ptr)); // array access
-        delete (yyvsp[-3].union_string);
+        (yyval.union_variable_ptr) = new Variable((yyvsp[-3].union_id), (yyvsp[-1].union_expression_ptr)); // array access
+        loop_bounds.indexed((yyval.union_variable_ptr));
     }
-#line 1967 "gpl.tab.c"
+#line 2077 "gpl.tab.c"
     break;
 
-  case 91: /* variable: "identifier" "." "identifier"  */
-#line 554 "gpl.y"
+  case 98: /* variable: "identifier" "." "identifier"  */
+#line 549 "gpl.y"
                         {
-        (yyval.union_variable_ptr) = new Variable(""); // placeholder, implemented later
-        delete (yyvsp[-2].union_string);
-        delete (yyvsp[0].union_string);
+        (yyval.union_variable_ptr) = new Variable(identifiers.intern("")); // placeholder, implemented later
     }
-#line 1977 "gpl.tab.c"
+#line 2085 "gpl.tab.c"
     break;
 
-  case 92: /* variable: "identifier" "[" expression "]" "." "identifier"  */
-#line 559 "gpl.y"
+  case 99: /* variable: "identifier" "[" expression "]" "." "identifier"  */
+#line 552 "gpl.y"
                                                           {
-        (yyval.union_variable_ptr) = new Variable("");
-        delete (yyvsp[-5].union_string);
-        delete (yyvsp[-3].union_expression_ptr);
-        delete (yyvsp[0].union_string);
+        (yyval.union_variable_ptr) = new Variable(identifiers.intern(""));
+        Expression::destroy((yyvsp[-3].union_expression_ptr));
     }
-#line 1988 "gpl.tab.c"
+#line 2094 "gpl.tab.c"
     break;
 
-  case 93: /* expression: primary_expression  */
-#line 568 "gpl.y"
+  case 100: /* expression: primary_expression  */
+#line 559 "gpl.y"
                                {(yyval.union_expression_ptr)=(yyvsp[0].union_expression_ptr);}
-#line 1994 "gpl.tab.c"
+#line 2100 "gpl.tab.c"
     break;
 
-  case 94: /* expression: expression "||" expression  */
-#line 571 "gpl.y"
-                               { (yyval.union_expression_ptr)=new Or((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));}
-#line 2000 "gpl.tab.c"
+  case 101: /* expression: expression "||" expression  */
+#line 562 "gpl.y"
+                               { (yyval.union_expression_ptr)=fold(new Or((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));}
+#line 2106 "gpl.tab.c"
     break;
 
-  case 95: /* expression: expression "&&" expression  */
-#line 572 "gpl.y"
-                                  { (yyval.union_expression_ptr)=new And((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));}
-#line 2006 "gpl.tab.c"
+  case 102: /* expression: expression "&&" expression  */
+#line 563 "gpl.y"
+                                  { (yyval.union_expression_ptr)=fold(new And((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));}
+#line 2112 "gpl.tab.c"
     break;
 
-  case 96: /* expression: expression "<=" expression  */
-#line 573 "gpl.y"
-                                         {(yyval.union_expression_ptr)=new LessThanOrEqual((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));}
-#line 2012 "gpl.tab.c"
+  case 103: /* expression: expression "<=" expression  */
+#line 564 "gpl.y"
+                                         {(yyval.union_expression_ptr)=fold(make_comparison(gamelang::LESS_EQUAL, (yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));}
+#line 2118 "gpl.tab.c"
     break;
 
-  case 97: /* expression: expression ">=" expression  */
-#line 574 "gpl.y"
-                                             {(yyval.union_expression_ptr)=new GreaterThanOrEqual((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));}
-#line 2018 "gpl.tab.c"
+  case 104: /* expression: expression ">=" expression  */
+#line 565 "gpl.y"
+                                             {(yyval.union_expression_ptr)=fold(make_comparison(gamelang::GREATER_EQUAL, (yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));}
+#line 2124 "gpl.tab.c"
     break;
 
-  case 98: /* expression: expression "<" expression  */
-#line 575 "gpl.y"
-                                   {(yyval.union_expression_ptr)=new LessThan((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));}
-#line 2024 "gpl.tab.c"
+  case 105: /* expression: expression "<" expression  */
+#line 566 "gpl.y"
+                                   {(yyval.union_expression_ptr)=fold(make_comparison(gamelang::LESS_THAN, (yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));}
+#line 2130 "gpl.tab.c"
     break;
 
-  case 99: /* expression: expression ">" expression  */
-#line 576 "gpl.y"
-                                       {(yyval.union_expression_ptr)=new GreaterThan((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));}
-#line 2030 "gpl.tab.c"
+  case 106: /* expression: expression ">" expression  */
+#line 567 "gpl.y"
+                                       {(yyval.union_expression_ptr)=fold(make_comparison(gamelang::GREATER_THAN, (yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));}
+#line 2136 "gpl.tab.c"
     break;
 
-  case 100: /* expression: expression "==" expression  */
-#line 577 "gpl.y"
-                                    {(yyval.union_expression_ptr)=new Equal((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));}
-#line 2036 "gpl.tab.c"
+  case 107: /* expression: expression "==" expression  */
+#line 568 "gpl.y"
+                                    {(yyval.union_expression_ptr)=fold(make_comparison(gamelang::EQUAL, (yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));}
+#line 2142 "gpl.tab.c"
     break;
 
-  case 101: /* expression: expression "!=" expression  */
-#line 578 "gpl.y"
-                                        {(yyval.union_expression_ptr)=new NotEqual((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));}
-#line 2042 "gpl.tab.c"
+  case 108: /* expression: expression "!=" expression  */
+#line 569 "gpl.y"
+                                        {(yyval.union_expression_ptr)=fold(make_comparison(gamelang::NOT_EQUAL, (yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));}
+#line 2148 "gpl.tab.c"
     break;
 
-  case 102: /* expression: expression "+" expression  */
-#line 579 "gpl.y"
-                                    { (yyval.union_expression_ptr)=new Add((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)); }
-#line 2048 "gpl.tab.c"
+  case 109: /* expression: expression "+" expression  */
+#line 570 "gpl.y"
+                                    { (yyval.union_expression_ptr)=fold(new Add((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr))); }
+#line 2154 "gpl.tab.c"
     break;
 
-  case 103: /* expression: expression "-" expression  */
-#line 580 "gpl.y"
+  case 110: /* expression: expression "-" expression  */
+#line 571 "gpl.y"
                                     {
         gamelang::Type left_type = (yyvsp[-2].union_expression_ptr)->type();
         gamelang::Type right_type = (yyvsp[0].union_expression_ptr)->type();
@@ -2059,18 +2165,18 @@ yyreduce:
         if (!valid_right)
             gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "-");
         if (valid_left && valid_right)
-            (yyval.union_expression_ptr) = new Subtract((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));
+            (yyval.union_expression_ptr) = fold(new Subtract((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));
         else {
-            (yyval.union_expression_ptr) = new Integer_constant(0);
-            delete (yyvsp[-2].union_expression_ptr);
-            delete (yyvsp[0].union_expression_ptr);
+            (yyval.union_expression_ptr) = literals.integer(0);
+            Expression::destroy((yyvsp[-2].union_expression_ptr));
+            Expression::destroy((yyvsp[0].union_expression_ptr));
         }
       }
-#line 2070 "gpl.tab.c"
+#line 2176 "gpl.tab.c"
     break;
 
-  case 104: /* expression: expression "*" expression  */
-#line 597 "gpl.y"
+  case 111: /* expression: expression "*" expression  */
+#line 588 "gpl.y"
                                        {
         gamelang::Type left_type = (yyvsp[-2].union_expression_ptr)->type();
         gamelang::Type right_type = (yyvsp[0].union_expression_ptr)->type();
@@ -2081,18 +2187,18 @@ yyreduce:
         if (!valid_right)
             gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "*");
         if (valid_left && valid_right)
-            (yyval.union_expression_ptr) = new Multiply((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));
+            (yyval.union_expression_ptr) = fold(new Multiply((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));
         else {
-            (yyval.union_expression_ptr) = new Integer_constant(0);
-            delete (yyvsp[-2].union_expression_ptr);
-            delete (yyvsp[0].union_expression_ptr);
+            (yyval.union_expression_ptr) = literals.integer(0);
+            Expression::destroy((yyvsp[-2].union_expression_ptr));
+            Expression::destroy((yyvsp[0].union_expression_ptr));
         }
     }
-#line 2092 "gpl.tab.c"
+#line 2198 "gpl.tab.c"
     break;
 
-  case 105: /* expression: expression "/" expression  */
-#line 614 "gpl.y"
+  case 112: /* expression: expression "/" expression  */
+#line 605 "gpl.y"
                                      {
         gamelang::Type left_type = (yyvsp[-2].union_expression_ptr)->type();
         gamelang::Type right_type = (yyvsp[0].union_expression_ptr)->type();
@@ -2103,18 +2209,18 @@ yyreduce:
         if (!valid_right)
             gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "/");
         if (valid_left && valid_right)
-            (yyval.union_expression_ptr) = new Divide((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));
+            (yyval.union_expression_ptr) = fold(new Divide((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));
         else {
-            (yyval.union_expression_ptr) = new Integer_constant(0);
-            delete (yyvsp[-2].union_expression_ptr);
-            delete (yyvsp[0].union_expression_ptr);
+            (yyval.union_expression_ptr) = literals.integer(0);
+            Expression::destroy((yyvsp[-2].union_expression_ptr));
+            Expression::destroy((yyvsp[0].union_expression_ptr));
         }
     }
-#line 2114 "gpl.tab.c"
+#line 2220 "gpl.tab.c"
     break;
 
-  case 106: /* expression: expression "%" expression  */
-#line 631 "gpl.y"
+  case 113: /* expression: expression "%" expression  */
+#line 622 "gpl.y"
                                   {
         gamelang::Type left_type = (yyvsp[-2].union_expression_ptr)->type();
         gamelang::Type right_type = (yyvsp[0].union_expression_ptr)->type();
@@ -2125,141 +2231,144 @@ yyreduce:
         if (!valid_right)
             gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "%");
         if (valid_left && valid_right)
-            (yyval.union_expression_ptr) = new Mod((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr));
+            (yyval.union_expression_ptr) = fold(new Mod((yyvsp[-2].union_expression_ptr), (yyvsp[0].union_expression_ptr)));
         else {
-            (yyval.union_expression_ptr) = new Integer_constant(0);
-            delete (yyvsp[-2].union_expression_ptr);
-            delete (yyvsp[0].union_expression_ptr);
+            (yyval.union_expression_ptr) = literals.integer(0);
+            Expression::destroy((yyvsp[-2].union_expression_ptr));
+            Expression::destroy((yyvsp[0].union_expression_ptr));
         }
     }
-#line 2136 "gpl.tab.c"
+#line 2242 "gpl.tab.c"
     break;
 
-  case 107: /* expression: "-" expression  */
-#line 648 "gpl.y"
+  case 114: /* expression: "-" expression  */
+#line 639 "gpl.y"
                                          {
         gamelang::Type expr_type = (yyvsp[0].union_expression_ptr)->type();
         if (expr_type != gamelang::INT && expr_type != gamelang::DOUBLE) {
             gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "-");
-            (yyval.union_expression_ptr) = new Integer_constant(0);
-            delete (yyvsp[0].union_expression_ptr);
+            (yyval.union_expression_ptr) = literals.integer(0);
+            Expression::destroy((yyvsp[0].union_expression_ptr));
         } else {
-            (yyval.union_expression_ptr) = new Negation((yyvsp[0].union_expression_ptr));
+            (yyval.union_expression_ptr) = fold(new Negation((yyvsp[0].union_expression_ptr)));
         }
     }
-#line 2151 "gpl.tab.c"
+#line 2257 "gpl.tab.c"
     break;
 
-  case 108: /* expression: "!" expression  */
-#line 658 "gpl.y"
-                        {(yyval.union_expression_ptr)=new Not((yyvsp[0].union_expression_ptr));}
-#line 2157 "gpl.tab.c"
+  case 115: /* expression: "!" expression  */
+#line 649 "gpl.y"
+                        {(yyval.union_expression_ptr)=fold(new Not((yyvsp[0].union_expression_ptr)));}
+#line 2263 "gpl.tab.c"
     break;
 
-  case 111: /* primary_expression: "sin" "(" expression ")"  */
-#line 664 "gpl.y"
-                                       {(yyval.union_expression_ptr)=new Sin((yyvsp[-1].union_expression_ptr));}
-#line 2163 "gpl.tab.c"
+  case 118: /* primary_expression: "sin" "(" expression ")"  */
+#line 655 "gpl.y"
+                                       {(yyval.union_expression_ptr)=fold(new Sin((yyvsp[-1].union_expression_ptr)));}
+#line 2269 "gpl.tab.c"
     break;
 
-  case 112: /* primary_expression: "cos" "(" expression ")"  */
-#line 665 "gpl.y"
-                                         {(yyval.union_expression_ptr)=new Cos((yyvsp[-1].union_expression_ptr));}
-#line 2169 "gpl.tab.c"
+  case 119: /* primary_expression: "cos" "(" expression ")"  */
+#line 656 "gpl.y"
+                                         {(yyval.union_expression_ptr)=fold(new Cos((yyvsp[-1].union_expression_ptr)));}
+#line 2275 "gpl.tab.c"
     break;
 
-  case 113: /* primary_expression: "tan" "(" expression ")"  */
-#line 666 "gpl.y"
-                                         {(yyval.union_expression_ptr)=new Tan((yyvsp[-1].union_expression_ptr));}
-#line 2175 "gpl.tab.c"
+  case 120: /* primary_expression: "tan" "(" expression ")"  */
+#line 657 "gpl.y"
+                                         {(yyval.union_expression_ptr)=fold(new Tan((yyvsp[-1].union_expression_ptr)));}
+#line 2281 "gpl.tab.c"
     break;
 
-  case 114: /* primary_expression: "asin" "(" expression ")"  */
-#line 667 "gpl.y"
-                                          {(yyval.union_expression_ptr)=new Asin((yyvsp[-1].union_expression_ptr));}
-#line 2181 "gpl.tab.c"
+  case 121: /* primary_expression: "asin" "(" expression ")"  */
+#line 658 "gpl.y"
+                                          {(yyval.union_expression_ptr)=fold(new Asin((yyvsp[-1].union_expression_ptr)));}
+#line 2287 "gpl.tab.c"
     break;
 
-  case 115: /* primary_expression: "acos" "(" expression ")"  */
-#line 668 "gpl.y"
-                                          {(yyval.union_expression_ptr)=new Acos((yyvsp[-1].union_expression_ptr));}
-#line 2187 "gpl.tab.c"
+  case 122: /* primary_expression: "acos" "(" expression ")"  */
+#line 659 "gpl.y"
+                                          {(yyval.union_expression_ptr)=fold(new Acos((yyvsp[-1].union_expression_ptr)));}
+#line 2293 "gpl.tab.c"
     break;
 
-  case 116: /* primary_expression: "atan" "(" expression ")"  */
-#line 669 "gpl.y"
-                                          {(yyval.union_expression_ptr)=new Atan((yyvsp[-1].union_expression_ptr));}
-#line 2193 "gpl.tab.c"
+  case 123: /* primary_expression: "atan" "(" expression ")"  */
+#line 660 "gpl.y"
+                                          {(yyval.union_expression_ptr)=fold(new Atan((yyvsp[-1].union_expression_ptr)));}
+#line 2299 "gpl.tab.c"
     break;
 
-  case 117: /* primary_expression: "sqrt" "(" expression ")"  */
-#line 670 "gpl.y"
-                                          {(yyval.union_expression_ptr)=new Sqrt((yyvsp[-1].union_expression_ptr));}
-#line 2199 "gpl.tab.c"
+  case 124: /* primary_expression: "sqrt" "(" expression ")"  */
+#line 661 "gpl.y"
+                                          {(yyval.union_expression_ptr)=fold(new Sqrt((yyvsp[-1].union_expression_ptr)));}
+#line 2305 "gpl.tab.c"
     break;
 
-  case 118: /* primary_expression: "abs" "(" expression ")"  */
-#line 671 "gpl.y"
-                                         {(yyval.union_expression_ptr)=new Abs((yyvsp[-1].union_expression_ptr));}
-#line 2205 "gpl.tab.c"
+  case 125: /* primary_expression: "abs" "(" expression ")"  */
+#line 662 "gpl.y"
+                                         {(yyval.union_expression_ptr)=fold(new Abs((yyvsp[-1].union_expression_ptr)));}
+#line 2311 "gpl.tab.c"
     break;
 
-  case 119: /* primary_expression: "floor" "(" expression ")"  */
-#line 672 "gpl.y"
-                                           {(yyval.union_expression_ptr)=new Floor((yyvsp[-1].union_expression_ptr));}
-#line 2211 "gpl.tab.c"
+  case 126: /* primary_expression: "floor" "(" expression ")"  */
+#line 663 "gpl.y"
+                                           {(yyval.union_expression_ptr)=fold(new Floor((yyvsp[-1].union_expression_ptr)));}
+#line 2317 "gpl.tab.c"
     break;
 
-  case 120: /* primary_expression: "random" "(" expression ")"  */
-#line 673 "gpl.y"
+  case 127: /* primary_expression: "random" "(" expression ")"  */
+#line 664 "gpl.y"
                                             {(yyval.union_expression_ptr)=new Random((yyvsp[-1].union_expression_ptr));}
-#line 2217 "gpl.tab.c"
+#line 2323 "gpl.tab.c"
     break;
 
-  case 121: /* primary_expression: "(" expression ")"  */
-#line 678 "gpl.y"
+  case 128: /* primary_expression: "(" expression ")"  */
+#line 669 "gpl.y"
                                  {(yyval.union_expression_ptr)= (yyvsp[-1].union_expression_ptr);}
-#line 2223 "gpl.tab.c"
+#line 2329 "gpl.tab.c"
     break;
 
-  case 122: /* primary_expression: variable  */
-#line 679 "gpl.y"
+  case 129: /* primary_expression: variable  */
+#line 670 "gpl.y"
                {(yyval.union_expression_ptr) = (yyvsp[0].union_variable_ptr);}
-#line 2229 "gpl.tab.c"
+#line 2335 "gpl.tab.c"
     break;
 
-  case 123: /* primary_expression: "int constant"  */
-#line 680 "gpl.y"
-                     { (yyval.union_expression_ptr)=new Integer_constant((yyvsp[0].union_int)); }
-#line 2235 "gpl.tab.c"
+  case 130: /* primary_expression: "int constant"  */
+#line 671 "gpl.y"
+                     { (yyval.union_expression_ptr)=literals.integer((yyvsp[0].union_int)); }
+#line 2341 "gpl.tab.c"
     break;
 
-  case 124: /* primary_expression: "true"  */
-#line 681 "gpl.y"
-             { (yyval.union_expression_ptr)=new Integer_constant(1); }
-#line 2241 "gpl.tab.c"
+  case 131: /* primary_expression: "true"  */
+#line 672 "gpl.y"
+             { (yyval.union_expression_ptr)=literals.integer(1); }
+#line 2347 "gpl.tab.c"
     break;
 
-  case 125: /* primary_expression: "false"  */
-#line 682 "gpl.y"
-              { (yyval.union_expression_ptr)=new Integer_constant(0); }
-#line 2247 "gpl.tab.c"
+  case 132: /* primary_expression: "false"  */
+#line 673 "gpl.y"
+              { (yyval.union_expression_ptr)=literals.integer(0); }
+#line 2353 "gpl.tab.c"
     break;
 
-  case 126: /* primary_expression: "double constant"  */
-#line 683 "gpl.y"
-                        { (yyval.union_expression_ptr) = new Double_constant((yyvsp[0].union_double)); }
-#line 2253 "gpl.tab.c"
+  case 133: /* primary_expression: "double constant"  */
+#line 674 "gpl.y"
+                        { (yyval.union_expression_ptr) = literals.real((yyvsp[0].union_double)); }
+#line 2359 "gpl.tab.c"
     break;
 
-  case 127: /* primary_expression: "string constant"  */
-#line 684 "gpl.y"
-                        { (yyval.union_expression_ptr) = new String_constant(*(yyvsp[0].union_string)); delete (yyvsp[0].union_string); }
-#line 2259 "gpl.tab.c"
+  case 134: /* primary_expression: "string constant"  */
+#line 675 "gpl.y"
+                        {
+        (yyval.union_expression_ptr) = literals.string((yyvsp[0].union_slice).view());
+        source_buffer.release((yyvsp[0].union_slice));
+    }
+#line 2368 "gpl.tab.c"
     break;
 
 
-#line 2263 "gpl.tab.c"
+#line 2372 "gpl.tab.c"
 
       default: break;
     }
@@ -2483,5 +2592,5 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 687 "gpl.y"
+#line 681 "gpl.y"
 
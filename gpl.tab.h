@@ -48,6 +48,8 @@ extern int yydebug;
 #line 1 "gpl.y"
 
   #include <string>
+  #include "source_buffer.h"
+  #include "loop_bounds.h"
   class Expression;
   class Variable;
   class Statement;
@@ -58,7 +60,7 @@ extern int yydebug;
     #include "Window.h"
   #endif
 
-#line 62 "gpl.tab.h"
+#line 64 "gpl.tab.h"
 
 /* Token kinds.  */
 #ifndef YYTOKENTYPE
@@ -169,16 +171,18 @@ extern int yydebug;
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 32 "gpl.y"
+#line 48 "gpl.y"
 
  int            union_int;
- std::string*   union_string;  // MUST be a pointer to a string
+ int            union_id;      // an identifier's id in identifiers
+ Source_slice   union_slice;   // text of a string constant
  double         union_double;
  gamelang::Type union_gpl_type;
  const Expression* union_expression_ptr;
  Variable* union_variable_ptr;
+ Assignment_form union_assignment;
 
-#line 182 "gpl.tab.h"
+#line 186 "gpl.tab.h"
 
 };
 typedef union YYSTYPE YYSTYPE;
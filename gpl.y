@@ -1,5 +1,7 @@
 %code requires{
   #include <string>
+  #include "source_buffer.h"
+  #include "loop_bounds.h"
   class Expression;
   class Variable;
   class Statement;
@@ -13,8 +15,18 @@
 // bison syntax to indicate the beginning of a C/C++ code section
 %{
 #include "scope_man.h"
+#include "intern_pool.h"
 #include "Constant.h"
+#include "arena.h"
+#include "literal_pool.h"
+#include "statement_block.h"
+// ast_arena must be defined before sm so it outlives the symbols sm owns,
+// before literals, whose Constants it holds, and before statement_builder,
+// whose blocks own the statements' expressions
+Arena ast_arena;
+Literal_pool literals;
 Scope_manager sm;
+Statement_builder statement_builder;
 extern int yylex();  // prototype of function generated by flex
 extern int yyerror(const char *); // used to print errors
 extern int line_count;            // current line in the input; from record.l
@@ -22,6 +34,10 @@ extern int line_count;            // current line in the input; from record.l
 #include "error.h"      // class for printing errors (used by gpl)
 #include <iostream>
 
+// a declaration's initial value may nest far deeper than bison's default
+// limit of 10000 states; the parser stack is malloc'd, so let it grow
+#define YYMAXDEPTH (1 << 24)
+
 // bison syntax indicating the end of a C/C++ code section
 %} 
 
@@ -31,15 +47,15 @@ extern int line_count;            // current line in the input; from record.l
 
 %union {
  int            union_int;
- std::string*   union_string;  // MUST be a pointer to a string
+ int            union_id;      // an identifier's id in identifiers
+ Source_slice   union_slice;   // text of a string constant
  double         union_double;
  gamelang::Type union_gpl_type;
  const Expression* union_expression_ptr;
  Variable* union_variable_ptr;
+ Assignment_form union_assignment;
 }
 
-%destructor { delete $$; } <union_string>
-
 // tokens declared here
 
 %token T_INT                 "int"
@@ -59,8 +75,8 @@ extern int line_count;            // current line in the input; from record.l
 %token T_IF                  "if"
 %token T_FOR                 "for"
 %token T_ELSE                "else"
-%token <union_string> T_EXIT            "exit"  
-%token <union_string> T_PRINT           "print"  
+%token <union_int> T_EXIT            "exit"  
+%token <union_int> T_PRINT           "print"  
 %token T_TRUE                "true"
 %token T_FALSE               "false"
 
@@ -137,8 +153,8 @@ extern int line_count;            // current line in the input; from record.l
 
 %token <union_int> T_INT_CONSTANT    "int constant"
 %token <union_double> T_DOUBLE_CONSTANT "double constant"
-%token <union_string> T_STRING_CONSTANT "string constant"
-%token <union_string> T_ID            	 "identifier"
+%token <union_slice> T_STRING_CONSTANT  "string constant"
+%token <union_id> T_ID                	 "identifier"
 
  // special token that does not match any production 
  // used for characters that are not part of the language 
@@ -168,6 +184,9 @@ left T_GREATER
 %type <union_expression_ptr> expression
 %type <union_expression_ptr> optional_initializer
 %type <union_variable_ptr> variable
+%type <union_assignment> assign_statement
+%type <union_assignment> assign_statement_or_empty
+%type <union_int> if_header
 
 
 %%
@@ -193,163 +212,80 @@ declaration:
 //---------------------------------------------------------------------
 variable_declaration:
     simple_type T_ID optional_initializer {
-        if (!$2) { YYERROR; }
-        if(sm.defined_in_current_scope(*$2)) {
-            gamelang::error(gamelang::PREVIOUSLY_DECLARED_VARIABLE,*$2);
-            delete $2;
+        if(sm.defined_in_current_scope($2)) {
+            gamelang::error(gamelang::PREVIOUSLY_DECLARED_VARIABLE,identifiers.name($2));
             break;
         }
 
-        Symbol* symbol = nullptr;
-        try {
-            if ($1 == gamelang::INT) {
-                int val = 0;
-                if ($3 != nullptr) {
-                    if (auto var_expr = dynamic_cast<const Variable*>($3)) {
-                        Symbol* init_sym = sm.lookup(var_expr->get_symbol_name());
-                        if (init_sym && init_sym->get_count() > 1
-                            && var_expr->is_whole_array_reference())
-                        {
-                            gamelang::error(gamelang::VARIABLE_IS_AN_ARRAY, init_sym->get_name());
-                            delete $2; delete $3; break;
-                        }
-                    }
-
-                    std::unique_ptr<const Constant> constant($3->evaluate());
-                    if (constant == nullptr) {
-                        delete $2;
-                        delete $3;
-                        break;
-                    }
-
-                    gamelang::Type actual_type = constant->type();
-                    if (actual_type != gamelang::INT) {
-                        throw actual_type;
-                    }
-                    val = constant->as_int();
-                    delete $3;
+        Constant_ptr constant;
+        if ($3 != nullptr) {
+            if (auto var_expr = dynamic_cast<const Variable*>($3)) {
+                const Symbol* init_sym = var_expr->get_symbol();
+                if (init_sym && init_sym->get_count() > 1
+                    && var_expr->is_whole_array_reference())
+                {
+                    gamelang::error(gamelang::VARIABLE_IS_AN_ARRAY, init_sym->get_name());
+                    Expression::destroy($3); break;
                 }
-                symbol = new Symbol(*$2, new int(val));
             }
-            else if ($1 == gamelang::DOUBLE) {
-                double val = 0.0;
-                if ($3 != nullptr) {
-                    if (auto var_expr = dynamic_cast<const Variable*>($3)) {
-                        Symbol* init_sym = sm.lookup(var_expr->get_symbol_name());
-                        if (init_sym && init_sym->get_count() > 1
-                            && var_expr->is_whole_array_reference())
-                        {
-                            gamelang::error(gamelang::VARIABLE_IS_AN_ARRAY, init_sym->get_name());
-                            delete $2; delete $3; break;
-                        }
-                    }
-
-                    std::unique_ptr<const Constant> constant($3->evaluate());
-                    if (constant == nullptr) {
-                        delete $2;
-                        delete $3;
-                        break;
-                    }
-
-                    gamelang::Type actual_type = constant->type();
-                    if (actual_type != gamelang::DOUBLE &&
-                        actual_type != gamelang::INT) {
-                        throw actual_type;
-                    }
-                    val = constant->as_double();
-                    delete $3;
-                }
-                symbol = new Symbol(*$2, new double(val));
-            }
-            else if ($1 == gamelang::STRING) {
-                std::string val = "";
-                if ($3 != nullptr) {
-                    if (auto var_expr = dynamic_cast<const Variable*>($3)) {
-                        Symbol* init_sym = sm.lookup(var_expr->get_symbol_name());
-                        if (init_sym && init_sym->get_count() > 1
-                            && var_expr->is_whole_array_reference())
-                        {
-                            gamelang::error(gamelang::VARIABLE_IS_AN_ARRAY, init_sym->get_name());
-                            delete $2; delete $3; break;
-                        }
-                    }
-
-                    std::unique_ptr<const Constant> constant($3->evaluate());
-                    if (constant == nullptr) {
-                        delete $2;
-                        delete $3;
-                        break;
-                    }
-
-                    val = constant->as_string();
-                    delete $3;
-                }
-                symbol = new Symbol(*$2, new std::string(val));
+
+            constant = $3->evaluate();
+            gamelang::Type actual_type = $3->type();
+            Expression::destroy($3);
+            if (constant == nullptr)
+                break;
+
+            // checked from the static type, then from the value's own
+            // type, so the accessors below cannot fail
+            if (gamelang::converts_to(actual_type, $1))
+                actual_type = constant->type();
+            if (!gamelang::converts_to(actual_type, $1)) {
+                gamelang::error(gamelang::INVALID_TYPE_FOR_INITIAL_VALUE, gamelang::to_string(actual_type),
+                                identifiers.name($2), gamelang::to_string($1));
+                break;
             }
         }
-        catch (gamelang::Type actual_type) {
-            std::string expected = gamelang::to_string($1);
-            std::string actual = gamelang::to_string(actual_type);
-            gamelang::error(gamelang::INVALID_TYPE_FOR_INITIAL_VALUE, actual, *$2, expected);
-            delete $2;
-            if ($3 != nullptr) delete $3;
-            break;
-        }
 
+        Symbol* symbol;
+        if ($1 == gamelang::INT)
+            symbol = new Symbol($2, constant ? constant->as_int() : 0);
+        else if ($1 == gamelang::DOUBLE)
+            symbol = new Symbol($2, constant ? constant->as_double() : 0.0);
+        else
+            symbol = new Symbol($2, constant ? constant->as_string() : std::string());
         sm.add_to_current_scope(symbol);
-        delete $2;
     }
     | simple_type T_ID T_LBRACKET expression T_RBRACKET {
-        if (sm.defined_in_current_scope(*$2)) {
-            gamelang::error(gamelang::PREVIOUSLY_DECLARED_VARIABLE, *$2);
-            delete $2;
-            delete $4;
+        if (sm.defined_in_current_scope($2)) {
+            gamelang::error(gamelang::PREVIOUSLY_DECLARED_VARIABLE, identifiers.name($2));
+            Expression::destroy($4);
             break;
         }
 
-        std::unique_ptr<const Constant> size_constant($4->evaluate());
+        Constant_ptr size_constant = $4->evaluate();
         gamelang::Type size_type = size_constant ? size_constant->type() : gamelang::NO_TYPE;
 
         if (size_constant == nullptr) {
-            delete $2;
-            delete $4;
+            Expression::destroy($4);
             break;
         }
         if (size_type != gamelang::INT) {
             gamelang::error(gamelang::ARRAY_SIZE_MUST_BE_AN_INTEGER,
-                            gamelang::to_string(size_type), *$2);
-            delete $2;
-            delete $4;
+                            gamelang::to_string(size_type), identifiers.name($2));
+            Expression::destroy($4);
             break;
         }
 
         int size = size_constant->as_int();
         if (size < 1) {
-            gamelang::error(gamelang::INVALID_ARRAY_SIZE, *$2, std::to_string(size));
-            delete $2;
-            delete $4;
+            gamelang::error(gamelang::INVALID_ARRAY_SIZE, identifiers.name($2), std::to_string(size));
+            Expression::destroy($4);
             break;
         }
 
-        Symbol* sym = nullptr;
-        if ($1 == gamelang::INT) {
-            int* arr = new int[size];
-            for (int i = 0; i < size; i++) arr[i] = i;
-            sym = new Symbol(*$2, arr, size);
-        }
-        else if ($1 == gamelang::DOUBLE) {
-            double* arr = new double[size];
-            for (int i = 0; i < size; i++) arr[i] = i + 0.5;
-            sym = new Symbol(*$2, arr, size);
-        }
-        else if ($1 == gamelang::STRING) {
-            std::string* arr = new std::string[size];
-            for (int i = 0; i < size; i++) arr[i] = std::to_string(i);
-            sym = new Symbol(*$2, arr, size);
-        }
-        sm.add_to_current_scope(sym);
-        delete $2;
-        delete $4;
+        // element i starts as i, i + 0.5 or "i"
+        sm.add_to_current_scope(new Symbol($2, $1, size, Symbol_storage::INDEX));
+        Expression::destroy($4);
     }
     ;
 
@@ -415,12 +351,22 @@ block:
 
 //---------------------------------------------------------------------
 initialization_block:
-    T_INITIALIZATION statement_block
+    T_INITIALIZATION {
+        statement_builder.begin_block(Statement_block::INITIALIZATION);
+    }
+    statement_block {
+        statement_builder.end_block();
+    }
 
 
 //---------------------------------------------------------------------
 termination_block:
-    T_TERMINATION statement_block
+    T_TERMINATION {
+        statement_builder.begin_block(Statement_block::TERMINATION);
+    }
+    statement_block {
+        statement_builder.end_block();
+    }
 
 
 //---------------------------------------------------------------------
@@ -436,7 +382,12 @@ animation_parameter:
 
 //---------------------------------------------------------------------
 animation_block:
-    animation_declaration statement_block
+    animation_declaration {
+        statement_builder.begin_block(Statement_block::ANIMATION);
+    }
+    statement_block {
+        statement_builder.end_block();
+    }
 
 
 //---------------------------------------------------------------------
@@ -446,7 +397,12 @@ animation_declaration:
 
 //---------------------------------------------------------------------
 on_block:
-    T_ON keystroke statement_block
+    T_ON keystroke {
+        statement_builder.begin_block(Statement_block::ON);
+    }
+    statement_block {
+        statement_builder.end_block();
+    }
 
 
 //---------------------------------------------------------------------
@@ -500,67 +456,102 @@ statement_list:
 statement:
     if_statement
     | for_statement
-    | assign_statement T_SEMIC
+    | assign_statement T_SEMIC { statement_builder.assign($1); }
     | print_statement T_SEMIC
     | exit_statement T_SEMIC
 
 
 //---------------------------------------------------------------------
 if_statement:
-    T_IF T_LPAREN expression T_RPAREN statement %prec IF_NO_ELSE
-  | T_IF T_LPAREN expression T_RPAREN statement T_ELSE statement;
+    if_header statement %prec IF_NO_ELSE {
+        statement_builder.end_if($1);
+    }
+  | if_header statement T_ELSE {
+        $<union_int>$ = statement_builder.begin_else($1);
+    }
+    statement {
+        statement_builder.end_if($<union_int>4);
+    };
+
+
+//---------------------------------------------------------------------
+if_header:
+    T_IF T_LPAREN expression T_RPAREN {
+        $$ = statement_builder.begin_if($3);
+    }
 
 
 //---------------------------------------------------------------------
 for_statement:
-    T_FOR T_LPAREN assign_statement_or_empty T_SEMIC expression T_SEMIC assign_statement_or_empty T_RPAREN statement_or_block_of_statements
+    T_FOR T_LPAREN assign_statement_or_empty T_SEMIC expression T_SEMIC assign_statement_or_empty T_RPAREN {
+        loop_bounds.enter_loop($3, $5, $7);
+        statement_builder.begin_for($3, $5, $7);
+    }
+    statement_or_block_of_statements {
+        loop_bounds.leave_loop();
+        statement_builder.end_for();
+    }
 
 
 //---------------------------------------------------------------------
 print_statement:
-    T_PRINT T_LPAREN expression T_RPAREN
+    T_PRINT T_LPAREN expression T_RPAREN {
+        statement_builder.print($3, $1);
+    }
 
 
 //---------------------------------------------------------------------
 exit_statement:
-    T_EXIT T_LPAREN expression T_RPAREN
+    T_EXIT T_LPAREN expression T_RPAREN {
+        statement_builder.exit($3, $1);
+    }
 
 
 //---------------------------------------------------------------------
 assign_statement_or_empty:
-    assign_statement
-    | %empty
+    assign_statement { $$ = $1; }
+    | %empty { $$ = Assignment_form{Assignment_form::NONE, nullptr, nullptr}; }
 
 
 //---------------------------------------------------------------------
 assign_statement:
-    variable T_ASSIGN expression
-    | variable T_PLUS_ASSIGN expression
-    | variable T_MINUS_ASSIGN expression
-    | variable T_PLUS_PLUS
-    | variable T_MINUS_MINUS
+    variable T_ASSIGN expression {
+        $$ = Assignment_form{Assignment_form::ASSIGN, $1, $3};
+        loop_bounds.assigned($1);
+    }
+    | variable T_PLUS_ASSIGN expression {
+        $$ = Assignment_form{Assignment_form::PLUS_ASSIGN, $1, $3};
+        loop_bounds.assigned($1);
+    }
+    | variable T_MINUS_ASSIGN expression {
+        $$ = Assignment_form{Assignment_form::MINUS_ASSIGN, $1, $3};
+        loop_bounds.assigned($1);
+    }
+    | variable T_PLUS_PLUS {
+        $$ = Assignment_form{Assignment_form::PLUS_PLUS, $1, nullptr};
+        loop_bounds.assigned($1);
+    }
+    | variable T_MINUS_MINUS {
+        $$ = Assignment_form{Assignment_form::MINUS_MINUS, $1, nullptr};
+        loop_bounds.assigned($1);
+    }
 
 
 //---------------------------------------------------------------------
 variable:
     T_ID{
-    $$ = new Variable(*$1); // simple variable
-      delete $1;
+    $$ = new Variable($1); // simple variable
     }
     | T_ID T_LBRACKET expression T_RBRACKET{
-        $$ = new Variable(*$1, $3); // array access
-        delete $1;
+        $$ = new Variable($1, $3); // array access
+        loop_bounds.indexed($$);
     }
     | T_ID T_PERIOD T_ID{
-        $$ = new Variable(""); // placeholder, implemented later
-        delete $1;
-        delete $3;
+        $$ = new Variable(identifiers.intern("")); // placeholder, implemented later
     }
     | T_ID T_LBRACKET expression T_RBRACKET T_PERIOD T_ID {
-        $$ = new Variable("");
-        delete $1;
-        delete $3;
-        delete $6;
+        $$ = new Variable(identifiers.intern(""));
+        Expression::destroy($3);
     }
 
 
@@ -568,15 +559,15 @@ variable:
 expression: primary_expression {$$=$1;}
 
 expression:
-    expression T_OR expression { $$=new Or($1, $3);}
-    | expression T_AND expression { $$=new And($1, $3);}
-    | expression T_LESS_EQUAL expression {$$=new LessThanOrEqual($1, $3);}
-    | expression T_GREATER_EQUAL  expression {$$=new GreaterThanOrEqual($1, $3);}
-    | expression T_LESS expression {$$=new LessThan($1, $3);}
-    | expression T_GREATER  expression {$$=new GreaterThan($1, $3);}
-    | expression T_EQUAL expression {$$=new Equal($1, $3);}
-    | expression T_NOT_EQUAL expression {$$=new NotEqual($1, $3);}
-    | expression T_PLUS expression  { $$=new Add($1, $3); }
+    expression T_OR expression { $$=fold(new Or($1, $3));}
+    | expression T_AND expression { $$=fold(new And($1, $3));}
+    | expression T_LESS_EQUAL expression {$$=fold(make_comparison(gamelang::LESS_EQUAL, $1, $3));}
+    | expression T_GREATER_EQUAL  expression {$$=fold(make_comparison(gamelang::GREATER_EQUAL, $1, $3));}
+    | expression T_LESS expression {$$=fold(make_comparison(gamelang::LESS_THAN, $1, $3));}
+    | expression T_GREATER  expression {$$=fold(make_comparison(gamelang::GREATER_THAN, $1, $3));}
+    | expression T_EQUAL expression {$$=fold(make_comparison(gamelang::EQUAL, $1, $3));}
+    | expression T_NOT_EQUAL expression {$$=fold(make_comparison(gamelang::NOT_EQUAL, $1, $3));}
+    | expression T_PLUS expression  { $$=fold(new Add($1, $3)); }
     | expression T_MINUS expression {
         gamelang::Type left_type = $1->type();
         gamelang::Type right_type = $3->type();
@@ -587,11 +578,11 @@ expression:
         if (!valid_right)
             gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "-");
         if (valid_left && valid_right)
-            $$ = new Subtract($1, $3);
+            $$ = fold(new Subtract($1, $3));
         else {
-            $$ = new Integer_constant(0);
-            delete $1;
-            delete $3;
+            $$ = literals.integer(0);
+            Expression::destroy($1);
+            Expression::destroy($3);
         }
       }
     | expression T_MULTIPLY expression {
@@ -604,11 +595,11 @@ expression:
         if (!valid_right)
             gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "*");
         if (valid_left && valid_right)
-            $$ = new Multiply($1, $3);
+            $$ = fold(new Multiply($1, $3));
         else {
-            $$ = new Integer_constant(0);
-            delete $1;
-            delete $3;
+            $$ = literals.integer(0);
+            Expression::destroy($1);
+            Expression::destroy($3);
         }
     }
     | expression T_DIVIDE expression {
@@ -621,11 +612,11 @@ expression:
         if (!valid_right)
             gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "/");
         if (valid_left && valid_right)
-            $$ = new Divide($1, $3);
+            $$ = fold(new Divide($1, $3));
         else {
-            $$ = new Integer_constant(0);
-            delete $1;
-            delete $3;
+            $$ = literals.integer(0);
+            Expression::destroy($1);
+            Expression::destroy($3);
         }
     }
     | expression T_MOD expression {
@@ -638,38 +629,38 @@ expression:
         if (!valid_right)
             gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "%");
         if (valid_left && valid_right)
-            $$ = new Mod($1, $3);
+            $$ = fold(new Mod($1, $3));
         else {
-            $$ = new Integer_constant(0);
-            delete $1;
-            delete $3;
+            $$ = literals.integer(0);
+            Expression::destroy($1);
+            Expression::destroy($3);
         }
     }
     | T_MINUS  expression %prec NEGATION {
         gamelang::Type expr_type = $2->type();
         if (expr_type != gamelang::INT && expr_type != gamelang::DOUBLE) {
             gamelang::error(gamelang::INVALID_RIGHT_OPERAND_TYPE, "-");
-            $$ = new Integer_constant(0);
-            delete $2;
+            $$ = literals.integer(0);
+            Expression::destroy($2);
         } else {
-            $$ = new Negation($2);
+            $$ = fold(new Negation($2));
         }
     }
-    | T_NOT  expression {$$=new Not($2);}
+    | T_NOT  expression {$$=fold(new Not($2));}
     | expression T_NEAR expression
     | expression T_TOUCHES expression
 
 
 primary_expression:
-    T_SIN T_LPAREN expression T_RPAREN {$$=new Sin($3);}
-    | T_COS T_LPAREN expression T_RPAREN {$$=new Cos($3);}
-    | T_TAN T_LPAREN expression T_RPAREN {$$=new Tan($3);}
-    | T_ASIN T_LPAREN expression T_RPAREN {$$=new Asin($3);}
-    | T_ACOS T_LPAREN expression T_RPAREN {$$=new Acos($3);}
-    | T_ATAN T_LPAREN expression T_RPAREN {$$=new Atan($3);}
-    | T_SQRT T_LPAREN expression T_RPAREN {$$=new Sqrt($3);}
-    | T_ABS T_LPAREN expression T_RPAREN {$$=new Abs($3);}
-    | T_FLOOR T_LPAREN expression T_RPAREN {$$=new Floor($3);}
+    T_SIN T_LPAREN expression T_RPAREN {$$=fold(new Sin($3));}
+    | T_COS T_LPAREN expression T_RPAREN {$$=fold(new Cos($3));}
+    | T_TAN T_LPAREN expression T_RPAREN {$$=fold(new Tan($3));}
+    | T_ASIN T_LPAREN expression T_RPAREN {$$=fold(new Asin($3));}
+    | T_ACOS T_LPAREN expression T_RPAREN {$$=fold(new Acos($3));}
+    | T_ATAN T_LPAREN expression T_RPAREN {$$=fold(new Atan($3));}
+    | T_SQRT T_LPAREN expression T_RPAREN {$$=fold(new Sqrt($3));}
+    | T_ABS T_LPAREN expression T_RPAREN {$$=fold(new Abs($3));}
+    | T_FLOOR T_LPAREN expression T_RPAREN {$$=fold(new Floor($3));}
     | T_RANDOM T_LPAREN expression T_RPAREN {$$=new Random($3);}
 
 
@@ -677,11 +668,14 @@ primary_expression:
 primary_expression:
     T_LPAREN expression T_RPAREN {$$= $2;}
     | variable {$$ = $1;}
-    | T_INT_CONSTANT { $$=new Integer_constant($1); }
-    | T_TRUE { $$=new Integer_constant(1); }
-    | T_FALSE { $$=new Integer_constant(0); }
-    | T_DOUBLE_CONSTANT { $$ = new Double_constant($1); }
-    | T_STRING_CONSTANT { $$ = new String_constant(*$1); delete $1; }
+    | T_INT_CONSTANT { $$=literals.integer($1); }
+    | T_TRUE { $$=literals.integer(1); }
+    | T_FALSE { $$=literals.integer(0); }
+    | T_DOUBLE_CONSTANT { $$ = literals.real($1); }
+    | T_STRING_CONSTANT {
+        $$ = literals.string($1.view());
+        source_buffer.release($1);
+    }
 
 
 %%
@@ -0,0 +1,19 @@
+#include "intern_pool.h"
+
+Intern_pool identifiers;
+
+int Intern_pool::intern(std::string_view name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    int id = names.size();
+    names.emplace_back(name);
+    ids.emplace(names.back(), id);
+    return id;
+}
+
+int Intern_pool::find(std::string_view name) const {
+    auto it = ids.find(name);
+    return (it != ids.end()) ? it->second : NOT_FOUND;
+}
@@ -0,0 +1,36 @@
+#ifndef INTERN_POOL_H
+#define INTERN_POOL_H
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Intern_pool gives every distinct identifier a small integer id.  Ids are
+// dense (0, 1, 2, ...) and a name keeps its id for the life of the program,
+// so tables keyed by identifier compare and hash ints instead of strings.
+class Intern_pool {
+public:
+    // what find() returns for a name that has no id; never a valid id
+    static constexpr int NOT_FOUND = -1;
+
+    Intern_pool() = default;
+
+    // the id of name, creating one the first time name is seen
+    int intern(std::string_view name);
+    // the id of name, or NOT_FOUND if name has never been interned
+    int find(std::string_view name) const;
+    const std::string& name(int id) const { return names[id]; }
+    int size() const { return names.size(); }
+
+    Intern_pool(const Intern_pool&) = delete;
+    Intern_pool& operator=(const Intern_pool&) = delete;
+
+private:
+    std::deque<std::string> names;                  // indexed by id
+    std::unordered_map<std::string_view, int> ids;  // views into names
+};
+
+extern Intern_pool identifiers;
+
+#endif
@@ -641,20 +641,18 @@ char *yytext;
 #line 7 "gpl.l"
 #include "gpl.tab.h"
 #include "error.h"
+#include "intern_pool.h"
+#include "source_buffer.h"
 #include <iostream>
 
 int line_count = 1;
 
 void illegal_token_error() {
   gamelang::error(gamelang::ILLEGAL_TOKEN, yytext);
-
-  // create a string to hold the current text
-  // put that string in the yylval union so it can be used by parser
-  yylval.union_string = new std::string(yytext);
 }
 
-#line 656 "lex.yy.c"
-#line 657 "lex.yy.c"
+#line 654 "lex.yy.c"
+#line 655 "lex.yy.c"
 
 #define INITIAL 0
 
@@ -869,10 +867,10 @@ YY_DECL
 		}
 
 	{
-#line 23 "gpl.l"
+#line 21 "gpl.l"
 
 
-#line 875 "lex.yy.c"
+#line 873 "lex.yy.c"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -931,275 +929,275 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 25 "gpl.l"
+#line 23 "gpl.l"
 { /* ignore whitespace */ }
 	YY_BREAK
 case 2:
 YY_RULE_SETUP
-#line 27 "gpl.l"
+#line 25 "gpl.l"
 { return T_INT; }
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 28 "gpl.l"
+#line 26 "gpl.l"
 { return T_DOUBLE; }
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 29 "gpl.l"
+#line 27 "gpl.l"
 { return T_STRING; }
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 30 "gpl.l"
+#line 28 "gpl.l"
 { return T_TRIANGLE; }
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 31 "gpl.l"
+#line 29 "gpl.l"
 { return T_PIXMAP; }
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 32 "gpl.l"
+#line 30 "gpl.l"
 { return T_CIRCLE; }
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 33 "gpl.l"
+#line 31 "gpl.l"
 { return T_RECTANGLE; }
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 34 "gpl.l"
+#line 32 "gpl.l"
 { return T_TEXTBOX; }
 	YY_BREAK
 /* keywords */
 case 10:
 YY_RULE_SETUP
-#line 37 "gpl.l"
+#line 35 "gpl.l"
 { return T_FORWARD; }
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 38 "gpl.l"
+#line 36 "gpl.l"
 { return T_INITIALIZATION; }
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 39 "gpl.l"
+#line 37 "gpl.l"
 { return T_TERMINATION; }
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 40 "gpl.l"
+#line 38 "gpl.l"
 { return T_ON; }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 41 "gpl.l"
+#line 39 "gpl.l"
 { return T_ANIMATION; }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 42 "gpl.l"
+#line 40 "gpl.l"
 { return T_IF; }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 43 "gpl.l"
+#line 41 "gpl.l"
 { return T_FOR; }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 44 "gpl.l"
+#line 42 "gpl.l"
 { return T_ELSE; }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 45 "gpl.l"
+#line 43 "gpl.l"
 { yylval.union_int = line_count; return T_EXIT; }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 46 "gpl.l"
+#line 44 "gpl.l"
 { yylval.union_int = line_count; return T_PRINT; }
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 47 "gpl.l"
+#line 45 "gpl.l"
 { return T_TRUE; }
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 48 "gpl.l"
+#line 46 "gpl.l"
 { return T_FALSE; }
 	YY_BREAK
 /* event keys */
 case 22:
 YY_RULE_SETUP
-#line 51 "gpl.l"
+#line 49 "gpl.l"
 { return T_SPACE; }
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 52 "gpl.l"
+#line 50 "gpl.l"
 { return T_LEFTARROW; }
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 53 "gpl.l"
+#line 51 "gpl.l"
 { return T_RIGHTARROW; }
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 54 "gpl.l"
+#line 52 "gpl.l"
 { return T_UPARROW; }
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 55 "gpl.l"
+#line 53 "gpl.l"
 { return T_DOWNARROW; }
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
-#line 56 "gpl.l"
+#line 54 "gpl.l"
 { return T_LEFTMOUSE_DOWN; }
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
-#line 57 "gpl.l"
+#line 55 "gpl.l"
 { return T_MIDDLEMOUSE_DOWN; }
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 58 "gpl.l"
+#line 56 "gpl.l"
 { return T_RIGHTMOUSE_DOWN; }
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 59 "gpl.l"
+#line 57 "gpl.l"
 { return T_LEFTMOUSE_UP; }
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 60 "gpl.l"
+#line 58 "gpl.l"
 { return T_MIDDLEMOUSE_UP; }
 	YY_BREAK
 case 32:
 YY_RULE_SETUP
-#line 61 "gpl.l"
+#line 59 "gpl.l"
 { return T_RIGHTMOUSE_UP; }
 	YY_BREAK
 case 33:
 YY_RULE_SETUP
-#line 62 "gpl.l"
+#line 60 "gpl.l"
 { return T_MOUSE_MOVE; }
 	YY_BREAK
 case 34:
 YY_RULE_SETUP
-#line 63 "gpl.l"
+#line 61 "gpl.l"
 { return T_MOUSE_DRAG; }
 	YY_BREAK
 case 35:
 YY_RULE_SETUP
-#line 64 "gpl.l"
+#line 62 "gpl.l"
 { return T_F1; }
 	YY_BREAK
 case 36:
 YY_RULE_SETUP
-#line 65 "gpl.l"
+#line 63 "gpl.l"
 { return T_AKEY; }
 	YY_BREAK
 case 37:
 YY_RULE_SETUP
-#line 66 "gpl.l"
+#line 64 "gpl.l"
 { return T_SKEY; }
 	YY_BREAK
 case 38:
 YY_RULE_SETUP
-#line 67 "gpl.l"
+#line 65 "gpl.l"
 { return T_DKEY; }
 	YY_BREAK
 case 39:
 YY_RULE_SETUP
-#line 68 "gpl.l"
+#line 66 "gpl.l"
 { return T_FKEY; }
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 69 "gpl.l"
+#line 67 "gpl.l"
 { return T_HKEY; }
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 70 "gpl.l"
+#line 68 "gpl.l"
 { return T_JKEY; }
 	YY_BREAK
 case 42:
 YY_RULE_SETUP
-#line 71 "gpl.l"
+#line 69 "gpl.l"
 { return T_KKEY; }
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
-#line 72 "gpl.l"
+#line 70 "gpl.l"
 { return T_LKEY; }
 	YY_BREAK
 case 44:
 YY_RULE_SETUP
-#line 73 "gpl.l"
+#line 71 "gpl.l"
 { return T_WKEY; }
 	YY_BREAK
 case 45:
 YY_RULE_SETUP
-#line 74 "gpl.l"
+#line 72 "gpl.l"
 { return T_ZKEY; }
 	YY_BREAK
 /* punctuation */
 case 46:
 YY_RULE_SETUP
-#line 77 "gpl.l"
+#line 75 "gpl.l"
 { return T_LPAREN; }
 	YY_BREAK
 case 47:
 YY_RULE_SETUP
-#line 78 "gpl.l"
+#line 76 "gpl.l"
 { return T_RPAREN; }
 	YY_BREAK
 case 48:
 YY_RULE_SETUP
-#line 79 "gpl.l"
+#line 77 "gpl.l"
 { return T_LBRACE; }
 	YY_BREAK
 case 49:
 YY_RULE_SETUP
-#line 80 "gpl.l"
+#line 78 "gpl.l"
 { return T_RBRACE; }
 	YY_BREAK
 case 50:
 YY_RULE_SETUP
-#line 81 "gpl.l"
+#line 79 "gpl.l"
 { return T_LBRACKET; }
 	YY_BREAK
 case 51:
 YY_RULE_SETUP
-#line 82 "gpl.l"
+#line 80 "gpl.l"
 { return T_RBRACKET; }
 	YY_BREAK
 case 52:
 YY_RULE_SETUP
-#line 83 "gpl.l"
+#line 81 "gpl.l"
 { return T_SEMIC; }
 	YY_BREAK
 case 53:
 YY_RULE_SETUP
-#line 84 "gpl.l"
+#line 82 "gpl.l"
 { return T_COMMA; }
 	YY_BREAK
 case 54:
 YY_RULE_SETUP
-#line 85 "gpl.l"
+#line 83 "gpl.l"
 { return T_PERIOD; }
 	YY_BREAK
 /* assignment operators
@@ -1210,167 +1208,167 @@ YY_RULE_SETUP
   */
 case 55:
 YY_RULE_SETUP
-#line 93 "gpl.l"
+#line 91 "gpl.l"
 { return T_ASSIGN; }
 	YY_BREAK
 case 56:
 YY_RULE_SETUP
-#line 94 "gpl.l"
+#line 92 "gpl.l"
 { return T_PLUS_ASSIGN; }
 	YY_BREAK
 case 57:
 YY_RULE_SETUP
-#line 95 "gpl.l"
+#line 93 "gpl.l"
 { return T_MINUS_ASSIGN; }
 	YY_BREAK
 case 58:
 YY_RULE_SETUP
-#line 96 "gpl.l"
+#line 94 "gpl.l"
 { return T_PLUS_PLUS; }
 	YY_BREAK
 case 59:
 YY_RULE_SETUP
-#line 97 "gpl.l"
+#line 95 "gpl.l"
 { return T_MINUS_MINUS; }
 	YY_BREAK
 /* unary operators with textual names */
 /* (no precedence level required) */
 case 60:
 YY_RULE_SETUP
-#line 101 "gpl.l"
+#line 99 "gpl.l"
 { return T_SIN; }
 	YY_BREAK
 case 61:
 YY_RULE_SETUP
-#line 102 "gpl.l"
+#line 100 "gpl.l"
 { return T_COS; }
 	YY_BREAK
 case 62:
 YY_RULE_SETUP
-#line 103 "gpl.l"
+#line 101 "gpl.l"
 { return T_TAN; }
 	YY_BREAK
 case 63:
 YY_RULE_SETUP
-#line 104 "gpl.l"
+#line 102 "gpl.l"
 { return T_ASIN; }
 	YY_BREAK
 case 64:
 YY_RULE_SETUP
-#line 105 "gpl.l"
+#line 103 "gpl.l"
 { return T_ACOS; }
 	YY_BREAK
 case 65:
 YY_RULE_SETUP
-#line 106 "gpl.l"
+#line 104 "gpl.l"
 { return T_ATAN; }
 	YY_BREAK
 case 66:
 YY_RULE_SETUP
-#line 107 "gpl.l"
+#line 105 "gpl.l"
 { return T_SQRT; }
 	YY_BREAK
 case 67:
 YY_RULE_SETUP
-#line 108 "gpl.l"
+#line 106 "gpl.l"
 { return T_ABS; }
 	YY_BREAK
 case 68:
 YY_RULE_SETUP
-#line 109 "gpl.l"
+#line 107 "gpl.l"
 { return T_FLOOR; }
 	YY_BREAK
 case 69:
 YY_RULE_SETUP
-#line 110 "gpl.l"
+#line 108 "gpl.l"
 { return T_RANDOM; }
 	YY_BREAK
 /* graphical operators (also, add precedence level in .y file) */
 case 70:
 YY_RULE_SETUP
-#line 113 "gpl.l"
+#line 111 "gpl.l"
 { return T_TOUCHES; }
 	YY_BREAK
 case 71:
 YY_RULE_SETUP
-#line 114 "gpl.l"
+#line 112 "gpl.l"
 { return T_NEAR; }
 	YY_BREAK
 /* mathematical operators (also, add precedence level in .y file) */
 case 72:
 YY_RULE_SETUP
-#line 117 "gpl.l"
+#line 115 "gpl.l"
 { return T_MULTIPLY; }
 	YY_BREAK
 case 73:
 YY_RULE_SETUP
-#line 118 "gpl.l"
+#line 116 "gpl.l"
 { return T_DIVIDE; }
 	YY_BREAK
 case 74:
 YY_RULE_SETUP
-#line 119 "gpl.l"
+#line 117 "gpl.l"
 { return T_PLUS; }
 	YY_BREAK
 case 75:
 YY_RULE_SETUP
-#line 120 "gpl.l"
+#line 118 "gpl.l"
 { return T_MINUS; }
 	YY_BREAK
 case 76:
 YY_RULE_SETUP
-#line 121 "gpl.l"
+#line 119 "gpl.l"
 { return T_MOD; }
 	YY_BREAK
 /* logical operators (also, add precedence level in .y file) */
 case 77:
 YY_RULE_SETUP
-#line 124 "gpl.l"
+#line 122 "gpl.l"
 { return T_LESS; }
 	YY_BREAK
 case 78:
 YY_RULE_SETUP
-#line 125 "gpl.l"
+#line 123 "gpl.l"
 { return T_GREATER; }
 	YY_BREAK
 case 79:
 YY_RULE_SETUP
-#line 126 "gpl.l"
+#line 124 "gpl.l"
 { return T_LESS_EQUAL; }
 	YY_BREAK
 case 80:
 YY_RULE_SETUP
-#line 127 "gpl.l"
+#line 125 "gpl.l"
 { return T_GREATER_EQUAL; }
 	YY_BREAK
 case 81:
 YY_RULE_SETUP
-#line 128 "gpl.l"
+#line 126 "gpl.l"
 { return T_EQUAL; }
 	YY_BREAK
 case 82:
 YY_RULE_SETUP
-#line 129 "gpl.l"
+#line 127 "gpl.l"
 { return T_NOT_EQUAL; }
 	YY_BREAK
 case 83:
 YY_RULE_SETUP
-#line 130 "gpl.l"
+#line 128 "gpl.l"
 { return T_NOT; }
 	YY_BREAK
 case 84:
 YY_RULE_SETUP
-#line 131 "gpl.l"
+#line 129 "gpl.l"
 { return T_AND; }
 	YY_BREAK
 case 85:
 YY_RULE_SETUP
-#line 132 "gpl.l"
+#line 130 "gpl.l"
 { return T_OR; }
 	YY_BREAK
 case 86:
 YY_RULE_SETUP
-#line 135 "gpl.l"
+#line 133 "gpl.l"
 {
     yylval.union_int = atoi(yytext);
     return T_INT_CONSTANT;
@@ -1378,7 +1376,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 87:
 YY_RULE_SETUP
-#line 139 "gpl.l"
+#line 137 "gpl.l"
 {
     yylval.union_double = atof(yytext);
     return T_DOUBLE_CONSTANT;
@@ -1386,27 +1384,27 @@ YY_RULE_SETUP
 	YY_BREAK
 case 88:
 YY_RULE_SETUP
-#line 143 "gpl.l"
+#line 141 "gpl.l"
 {
-    std::string str(yytext + 1, strlen(yytext) - 2); // Strip quotes
-    yylval.union_string = new std::string(str);
+    // the text between the quotes, in place when the source is mapped
+    yylval.union_slice = source_buffer.slice(yytext + 1, yyleng - 2);
     return T_STRING_CONSTANT;
 }
 	YY_BREAK
 case 89:
 YY_RULE_SETUP
-#line 148 "gpl.l"
-{ yylval.union_string = new std::string(yytext); return T_ID; }
+#line 146 "gpl.l"
+{ yylval.union_id = identifiers.intern(std::string_view(yytext, yyleng)); return T_ID; }
 	YY_BREAK
 case 90:
 YY_RULE_SETUP
-#line 151 "gpl.l"
+#line 149 "gpl.l"
 { /* Do nothing, ignore the comment */ }
 	YY_BREAK
 case 91:
 /* rule 91 can match eol */
 YY_RULE_SETUP
-#line 153 "gpl.l"
+#line 151 "gpl.l"
 { line_count = line_count +1; }
 	YY_BREAK
 /* This should be the last pattern. If the lexer reaches this pattern
@@ -1414,15 +1412,15 @@ YY_RULE_SETUP
   */
 case 92:
 YY_RULE_SETUP
-#line 158 "gpl.l"
+#line 156 "gpl.l"
 {illegal_token_error(); return T_ERROR;}
 	YY_BREAK
 case 93:
 YY_RULE_SETUP
-#line 160 "gpl.l"
+#line 158 "gpl.l"
 YY_FATAL_ERROR( "flex scanner jammed" );
 	YY_BREAK
-#line 1425 "lex.yy.c"
+#line 1423 "lex.yy.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -2390,7 +2388,7 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 160 "gpl.l"
+#line 158 "gpl.l"
 
 
 
@@ -0,0 +1,62 @@
+#include "literal_pool.h"
+#include "Constant.h"
+#include <bit>
+
+Literal_pool::Literal_pool() {
+    small.reserve(SMALL_MAX - SMALL_MIN + 1);
+    for (int value = SMALL_MIN; value <= SMALL_MAX; value++)
+        small.push_back(share(new Integer_constant(value)));
+}
+
+Literal_pool::~Literal_pool() {
+    for (const Constant* constant : small)
+        delete constant;
+    for (auto& [value, constant] : ints)
+        delete constant;
+    for (auto& [bits, constant] : doubles)
+        delete constant;
+    for (auto& [text, constant] : strings)
+        delete constant;
+}
+
+const Constant* Literal_pool::share(Constant* constant) {
+    constant->shared = true;
+    return constant;
+}
+
+const Constant* Literal_pool::integer(int value) {
+    if (const Constant* constant = small_integer(value))
+        return constant;
+    auto it = ints.find(value);
+    if (it != ints.end())
+        return it->second;
+    return ints.emplace(value, share(new Integer_constant(value))).first->second;
+}
+
+// keyed by bits, so 0.0 and -0.0 stay apart
+const Constant* Literal_pool::real(double value) {
+    std::uint64_t bits = std::bit_cast<std::uint64_t>(value);
+    auto it = doubles.find(bits);
+    if (it != doubles.end())
+        return it->second;
+    return doubles.emplace(bits, share(new Double_constant(value))).first->second;
+}
+
+const Constant* Literal_pool::string(std::string_view value) {
+    auto it = strings.find(value);
+    if (it != strings.end())
+        return it->second;
+    const Constant* constant = share(new String_constant(std::string(value)));
+    std::string buffer;  // unused: a String_constant returns a view of its own text
+    strings.emplace(constant->string_value(buffer), constant);
+    return constant;
+}
+
+const Constant* Literal_pool::constant(const Value& value) {
+    switch (value.type()) {
+        case gamelang::INT:    return integer(value.as_int());
+        case gamelang::DOUBLE: return real(value.as_double());
+        case gamelang::STRING: return string(value.as_string());
+        default:               return nullptr;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef LITERAL_POOL_H
+#define LITERAL_POOL_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class Constant;
+class Value;
+
+// Literal_pool holds one immutable Constant for every distinct literal the
+// parser builds (and every value fold() computes), so equal literals share
+// a node.  The ints SMALL_MIN..SMALL_MAX, which cover true, false and the
+// 0 the parser substitutes after an error, are built up front.
+//
+// Pooled Constants are shared (Expression::is_shared()): the trees that
+// hold them and the Constant_ptrs that point at them never delete them,
+// and their evaluate() returns the Constant itself instead of a copy.  They
+// live until the pool is destroyed.
+class Literal_pool {
+public:
+    Literal_pool();
+    ~Literal_pool();
+
+    const Constant* integer(int value);
+    const Constant* real(double value);
+    const Constant* string(std::string_view value);
+    // the pooled Constant for value, or nullptr if value is not valid
+    const Constant* constant(const Value& value);
+    // the pooled Constant for value if it is one of the small ints built
+    // up front, else nullptr; never adds to the pool
+    const Constant* small_integer(int value) const
+    {
+        return value >= SMALL_MIN && value <= SMALL_MAX ? small[value - SMALL_MIN] : nullptr;
+    }
+
+    int size() const { return small.size() + ints.size() + doubles.size() + strings.size(); }
+
+    Literal_pool(const Literal_pool&) = delete;
+    Literal_pool& operator=(const Literal_pool&) = delete;
+
+private:
+    static constexpr int SMALL_MIN = -16;
+    static constexpr int SMALL_MAX = 255;
+
+    const Constant* share(Constant* constant);
+
+    std::vector<const Constant*> small;                        // SMALL_MIN..SMALL_MAX
+    std::unordered_map<int, const Constant*> ints;             // the others
+    std::unordered_map<std::uint64_t, const Constant*> doubles;  // by bit pattern
+    std::unordered_map<std::string_view, const Constant*> strings;  // views into the Constants
+};
+
+// Defined in gpl.y after ast_arena and before sm, so it is built after the
+// arena its Constants come from and destroyed after the Symbols and trees
+// that point at them.
+extern Literal_pool literals;
+
+#endif
@@ -0,0 +1,148 @@
+#include "loop_bounds.h"
+#include "Expression.h"
+#include "Constant.h"
+#include "symbol.h"
+#include <climits>
+
+Loop_bounds loop_bounds;
+
+namespace {
+
+// the symbol of expr if it is a plain int variable, else nullptr
+const Symbol* int_variable(const Expression* expr)
+{
+    auto variable = dynamic_cast<const Variable*>(expr);
+    if (!variable || !variable->is_whole_array_reference())
+        return nullptr;
+    const Symbol* symbol = variable->get_symbol();
+    if (!symbol || symbol->get_count() != 1 || symbol->get_type() != gamelang::INT)
+        return nullptr;
+    return symbol;
+}
+
+bool int_constant(const Expression* expr, long long& value)
+{
+    auto constant = dynamic_cast<const Constant*>(expr);
+    if (!constant || constant->type() != gamelang::INT)
+        return false;
+    value = constant->as_int();
+    return true;
+}
+
+// the largest value of i for which condition holds, if it is i < n,
+// i <= n, n > i or n >= i
+bool upper_bound(const Expression* condition, const Symbol* i, long long& high)
+{
+    auto comparison = dynamic_cast<const Binary_operator*>(condition);
+    if (!comparison)
+        return false;
+    const Expression* lhs = comparison->get_lhs();
+    const Expression* rhs = comparison->get_rhs();
+    long long n;
+    switch (comparison->get_operator()) {
+        case gamelang::LESS_THAN:
+        case gamelang::LESS_EQUAL:
+            if (int_variable(lhs) != i || !int_constant(rhs, n))
+                return false;
+            high = comparison->get_operator() == gamelang::LESS_THAN ? n - 1 : n;
+            return true;
+        case gamelang::GREATER_THAN:
+        case gamelang::GREATER_EQUAL:
+            if (int_variable(rhs) != i || !int_constant(lhs, n))
+                return false;
+            high = comparison->get_operator() == gamelang::GREATER_THAN ? n - 1 : n;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// i, i + c, c + i or i - c: the variable i and the offset c
+const Symbol* offset_variable(const Expression* index, long long& offset)
+{
+    offset = 0;
+    if (const Symbol* i = int_variable(index))
+        return i;
+    auto binary = dynamic_cast<const Binary_operator*>(index);
+    if (!binary)
+        return nullptr;
+    const Expression* lhs = binary->get_lhs();
+    const Expression* rhs = binary->get_rhs();
+    switch (binary->get_operator()) {
+        case gamelang::PLUS:
+            if (int_constant(rhs, offset))
+                return int_variable(lhs);
+            if (int_constant(lhs, offset))
+                return int_variable(rhs);
+            return nullptr;
+        case gamelang::MINUS:
+            if (!int_constant(rhs, offset))
+                return nullptr;
+            offset = -offset;
+            return int_variable(lhs);
+        default:
+            return nullptr;
+    }
+}
+
+}
+
+void Loop_bounds::enter_loop(const Assignment_form& init, const Expression* condition,
+                             const Assignment_form& update)
+{
+    Loop loop{nullptr, 0, 0, false, nullptr, 0};
+    const Symbol* i = init.kind == Assignment_form::ASSIGN ? int_variable(init.target) : nullptr;
+    long long low, high, step = 0;
+    bool counts_up = update.kind == Assignment_form::PLUS_PLUS
+        ? (step = 1, true)
+        : update.kind == Assignment_form::PLUS_ASSIGN && int_constant(update.value, step) && step > 0;
+
+    // the last step out of the loop must not overflow i back into range
+    if (i && int_constant(init.value, low) && counts_up && int_variable(update.target) == i
+        && upper_bound(condition, i, high) && low <= high && high + step <= INT_MAX) {
+        proofs.push_back(false);
+        loop = Loop{i, int(low), int(high), false, &proofs.back(), 0};
+    }
+    loops.push_back(loop);
+}
+
+void Loop_bounds::assigned(const Variable* target)
+{
+    const Symbol* symbol = target ? target->get_symbol() : nullptr;
+    for (Loop& loop : loops) {
+        if (loop.induction && loop.induction == symbol)
+            loop.induction_assigned = true;
+    }
+}
+
+void Loop_bounds::indexed(Variable* element)
+{
+    const Symbol* array = element->get_symbol();
+    if (loops.empty() || !array || array->get_count() <= 1)
+        return;
+    long long offset;
+    const Symbol* i = offset_variable(element->get_index_expression(), offset);
+    if (!i)
+        return;
+
+    // the innermost loop counting i decides
+    for (auto loop = loops.rbegin(); loop != loops.rend(); ++loop) {
+        if (loop->induction != i)
+            continue;
+        if (loop->low + offset >= 0 && loop->high + offset < array->get_count()) {
+            element->set_index_proof(loop->proof);
+            loop->elements++;
+        }
+        return;
+    }
+}
+
+void Loop_bounds::leave_loop()
+{
+    const Loop& loop = loops.back();
+    if (loop.induction && !loop.induction_assigned) {
+        *loop.proof = true;
+        unchecked += loop.elements;
+    }
+    loops.pop_back();
+}
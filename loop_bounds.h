@@ -0,0 +1,71 @@
+#ifndef LOOP_BOUNDS_H
+#define LOOP_BOUNDS_H
+
+#include <deque>
+#include <vector>
+
+class Expression;
+class Variable;
+class Symbol;
+
+// An assignment statement as Loop_bounds sees it: the variable assigned,
+// how, and the value (nullptr for ++ and --).  A for statement header that
+// leaves its initializer or update out has a NONE in its place.
+struct Assignment_form {
+    enum Kind { NONE, ASSIGN, PLUS_ASSIGN, MINUS_ASSIGN, PLUS_PLUS, MINUS_MINUS };
+    Kind kind;
+    const Variable* target;
+    const Expression* value;
+};
+
+// Loop_bounds removes array bounds checks from the bodies of counting loops
+//     for (i = 0; i < 100; i += 1) { ... a[i] ... a[i + 1] ... }
+// For a header that starts an int i at a constant, steps it up by a
+// positive constant and tests it against a constant (i < n, i <= n, n > i
+// or n >= i), i is within [start, n - 1] (or [start, n]) every time the
+// body runs, unless the body assigns i itself.  An element a[i], a[i + c]
+// or a[i - c] of a fixed-size array that stays within a's bounds over that
+// range is then evaluated without checking its index (Variable::element());
+// every other access keeps its check and ARRAY_INDEX_OUT_OF_BOUNDS.
+//
+// The parser reports each for statement and what is built inside it:
+//   enter_loop()  once the header has been parsed
+//   assigned()    for every assignment statement, in or out of a loop
+//   indexed()     for every array element expression
+//   leave_loop()  after the body
+// The body has not been seen when its elements are built, so an element
+// gets a pointer to its loop's proof, which leave_loop() sets if nothing in
+// the body assigned i.  Proofs live as long as the program.
+class Loop_bounds {
+public:
+    Loop_bounds() = default;
+
+    void enter_loop(const Assignment_form& init, const Expression* condition,
+                    const Assignment_form& update);
+    void assigned(const Variable* target);
+    void indexed(Variable* element);
+    void leave_loop();
+
+    // elements whose check was removed, for bench/bounds_bench
+    int unchecked_elements() const { return unchecked; }
+
+    Loop_bounds(const Loop_bounds&) = delete;
+    Loop_bounds& operator=(const Loop_bounds&) = delete;
+
+private:
+    struct Loop {
+        const Symbol* induction;  // nullptr if the header proves nothing
+        int low;
+        int high;
+        bool induction_assigned;  // by a statement in the body
+        bool* proof;
+        int elements;             // given proof
+    };
+    std::vector<Loop> loops;      // the for statements being parsed
+    std::deque<bool> proofs;
+    int unchecked = 0;
+};
+
+extern Loop_bounds loop_bounds;
+
+#endif
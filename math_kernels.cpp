@@ -0,0 +1,245 @@
+#include "math_kernels.h"
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Every kernel is a template over its lane type, double or __m128d, and is
+// written with operators only (g++ and clang++ define + - * / < ?: on
+// vector types), so both instantiations run the same operations in the
+// same order and give the same bits.  The few things operators cannot do
+// are overloaded below.
+
+namespace {
+
+constexpr double DEGREES_PER_RADIAN = 180.0 / std::numbers::pi;
+
+// pi / 180 split in two: the high part has 27 significant bits, so its
+// product with a reduced operand of up to 26 bits (any whole or
+// fractional number of degrees a program is likely to use) is exact
+constexpr double RADIANS_PER_DEGREE_HIGH = 0x1.1df46ap-6;
+constexpr double RADIANS_PER_DEGREE_LOW = 0x1.294e9c8ae0ec6p-33;
+
+// above this x - 90 * round(x / 90) is no longer exact; those operands are
+// first reduced with fmod(x, 360), which always is
+constexpr double REDUCTION_LIMIT = 0x1p50;
+
+// adding and subtracting 1.5 * 2^52 rounds |t| < 2^51 to an integer, which
+// the sum then holds in its low mantissa bits
+constexpr double ROUNDING_MAGIC = 0x1.8p52;
+
+template <typename V>
+V splat(double c) { return V{} + c; }
+
+double lane_sqrt(double x) { return std::sqrt(x); }
+double lane_abs(double x) { return std::fabs(x); }
+double lane_copysign(double magnitude, double sign) { return std::copysign(magnitude, sign); }
+int64_t lane_bits(double x) { return std::bit_cast<int64_t>(x); }
+
+#ifdef __SSE2__
+__m128d lane_sqrt(__m128d x) { return _mm_sqrt_pd(x); }
+__m128d lane_abs(__m128d x) { return _mm_andnot_pd(_mm_set1_pd(-0.0), x); }
+__m128d lane_copysign(__m128d magnitude, __m128d sign)
+{
+  __m128d sign_bit = _mm_set1_pd(-0.0);
+  return _mm_or_pd(_mm_andnot_pd(sign_bit, magnitude), _mm_and_pd(sign_bit, sign));
+}
+__m128i lane_bits(__m128d x) { return _mm_castpd_si128(x); }
+#endif
+
+// sin and cos on [-pi/4, pi/4] (fdlibm's __kernel_sin and __kernel_cos,
+// each within 1 ulp)
+template <typename V>
+V sin_kernel(V x)
+{
+  const double S1 = -1.66666666666666324348e-01;
+  const double S2 =  8.33333333332248946124e-03;
+  const double S3 = -1.98412698298579493134e-04;
+  const double S4 =  2.75573137070700676789e-06;
+  const double S5 = -2.50507602534068634195e-08;
+  const double S6 =  1.58969099521155010221e-10;
+  V z = x * x;
+  V r = S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)));
+  return x + z * x * (S1 + z * r);
+}
+
+template <typename V>
+V cos_kernel(V x)
+{
+  const double C1 =  4.16666666666666019037e-02;
+  const double C2 = -1.38888888888741095749e-03;
+  const double C3 =  2.48015872894767294178e-05;
+  const double C4 = -2.75573143513906633035e-07;
+  const double C5 =  2.08757232129817482790e-09;
+  const double C6 = -1.13596475577881948265e-11;
+  V z = x * x;
+  V r = z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+  V half_z = 0.5 * z;
+  V w = 1.0 - half_z;
+  return w + (((1.0 - w) - half_z) + z * r);
+}
+
+// x degrees = quadrant * 90 + reduced; reduced is exact, in about
+// [-45, 45] degrees, and returned in radians
+template <typename V, typename Bits>
+V reduce_degrees(V x, Bits& quadrant)
+{
+  V t = x * (1.0 / 90.0) + ROUNDING_MAGIC;
+  quadrant = lane_bits(t) & 3;
+  V n = t - ROUNDING_MAGIC;
+  V degrees = x - n * 90.0;
+  return degrees * RADIANS_PER_DEGREE_HIGH + degrees * RADIANS_PER_DEGREE_LOW;
+}
+
+// atan in radians (Cephes' atan: rational approximation after reducing
+// |x| to [0, 0.66])
+template <typename V>
+V atan_radians(V x)
+{
+  // -DP2 -DP3 are phase macros, so no P0 ... P4
+  const double P[] = {-8.750608600031904122785e-01, -1.615753718733365076637e+01,
+                      -7.500855792314704667340e+01, -1.228866684490136173410e+02,
+                      -6.485021904942025371773e+01};
+  const double Q[] = { 2.485846490142306297962e+01,  1.650270098316988542046e+02,
+                       4.328810604912902668951e+02,  4.853903996359136964868e+02,
+                       1.945506571482613964425e+02};
+  const double TAN_3PI_8 = 2.41421356237309504880;
+  const double MORE_BITS = 6.123233995736765886130e-17;  // pi/2 - (double) pi/2
+
+  V a = lane_abs(x);
+  auto big = a > TAN_3PI_8;
+  auto middle = a > 0.66;
+  V reduced = big ? -1.0 / a : (middle ? (a - 1.0) / (a + 1.0) : a);
+  V base = big ? splat<V>(std::numbers::pi / 2)
+                : (middle ? splat<V>(std::numbers::pi / 4) : V{});
+  V extra = big ? splat<V>(MORE_BITS) : (middle ? splat<V>(0.5 * MORE_BITS) : V{});
+
+  V z = reduced * reduced;
+  V p = (((P[0] * z + P[1]) * z + P[2]) * z + P[3]) * z + P[4];
+  V q = ((((z + Q[0]) * z + Q[1]) * z + Q[2]) * z + Q[3]) * z + Q[4];
+  V y = base + ((reduced * (z * p / q) + reduced) + extra);
+  return lane_copysign(y, x);
+}
+
+template <typename V>
+V sin_degrees(V x)
+{
+  decltype(lane_bits(x)) quadrant;
+  V r = reduce_degrees(x, quadrant);
+  V s = sin_kernel(r);
+  V c = cos_kernel(r);
+  V v = (quadrant & 1) != 0 ? c : s;
+  return (quadrant & 2) != 0 ? -v : v;
+}
+
+template <typename V>
+V cos_degrees(V x)
+{
+  decltype(lane_bits(x)) quadrant;
+  V r = reduce_degrees(x, quadrant);
+  V s = sin_kernel(r);
+  V c = cos_kernel(r);
+  V v = (quadrant & 1) != 0 ? s : c;
+  return ((quadrant + 1) & 2) != 0 ? -v : v;
+}
+
+template <typename V>
+V tan_degrees(V x)
+{
+  decltype(lane_bits(x)) quadrant;
+  V r = reduce_degrees(x, quadrant);
+  V s = sin_kernel(r);
+  V c = cos_kernel(r);
+  return (quadrant & 1) != 0 ? -c / s : s / c;
+}
+
+template <typename V>
+V asin_degrees(V x)
+{
+  return atan_radians(x / lane_sqrt((1.0 - x) * (1.0 + x))) * DEGREES_PER_RADIAN;
+}
+
+template <typename V>
+V acos_degrees(V x)
+{
+  return 2.0 * atan_radians(lane_sqrt((1.0 - x) / (1.0 + x))) * DEGREES_PER_RADIAN;
+}
+
+template <typename V>
+V atan_degrees(V x)
+{
+  return atan_radians(x) * DEGREES_PER_RADIAN;
+}
+
+double reduce_large(double x)
+{
+  return std::fabs(x) > REDUCTION_LIMIT ? std::fmod(x, 360.0) : x;
+}
+
+// Kernel is one of the functions above, instantiated for both lane types
+// by the lambda apply_math() passes in; Reduce says whether it takes
+// degrees and so needs huge operands reduced first
+template <bool Reduce, typename Kernel>
+void apply(Kernel kernel, const double* operands, double* results, int count)
+{
+  int i = 0;
+#ifdef __SSE2__
+  for (; i + 2 <= count; i += 2) {
+    __m128d x = _mm_loadu_pd(operands + i);
+    if (Reduce && _mm_movemask_pd(_mm_cmpgt_pd(lane_abs(x), _mm_set1_pd(REDUCTION_LIMIT)))) {
+      x = _mm_set_pd(reduce_large(operands[i + 1]), reduce_large(operands[i]));
+    }
+    _mm_storeu_pd(results + i, kernel(x));
+  }
+#endif
+  for (; i < count; i++) {
+    results[i] = kernel(Reduce ? reduce_large(operands[i]) : operands[i]);
+  }
+}
+
+}
+
+namespace gamelang {
+
+bool has_math_kernel(Operator op)
+{
+  switch (op) {
+    case SIN: case COS: case TAN:
+    case ASIN: case ACOS: case ATAN:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void apply_math(Operator op, const double* operands, double* results, int count)
+{
+  switch (op) {
+    case SIN:
+      apply<true>([](auto x) { return sin_degrees(x); }, operands, results, count);
+      break;
+    case COS:
+      apply<true>([](auto x) { return cos_degrees(x); }, operands, results, count);
+      break;
+    case TAN:
+      apply<true>([](auto x) { return tan_degrees(x); }, operands, results, count);
+      break;
+    case ASIN:
+      apply<false>([](auto x) { return asin_degrees(x); }, operands, results, count);
+      break;
+    case ACOS:
+      apply<false>([](auto x) { return acos_degrees(x); }, operands, results, count);
+      break;
+    case ATAN:
+      apply<false>([](auto x) { return atan_degrees(x); }, operands, results, count);
+      break;
+    default:
+      assert(has_math_kernel(op));
+  }
+}
+
+}
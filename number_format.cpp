@@ -0,0 +1,30 @@
+#include "number_format.h"
+#include <cassert>
+#include <charconv>
+#include <ostream>
+
+namespace gamelang {
+
+  Number_text::Number_text(int value)
+  {
+    std::to_chars_result result = std::to_chars(text, text + sizeof text, value);
+    assert(result.ec == std::errc());
+    length = result.ptr - text;
+  }
+
+  Number_text::Number_text(double value, Format format)
+  {
+    std::chars_format style = (format == STREAM) ? std::chars_format::general
+                                                 : std::chars_format::fixed;
+    std::to_chars_result result =
+      std::to_chars(text, text + sizeof text, value, style, 6);
+    assert(result.ec == std::errc());
+    length = result.ptr - text;
+  }
+
+  std::ostream& operator<<(std::ostream& os, const Number_text& number)
+  {
+    std::string_view text = number.view();
+    return os.write(text.data(), text.size());
+  }
+}
@@ -0,0 +1,48 @@
+/*
+ * gamelang::Number_text  an int or double formatted with std::to_chars:
+ *                        no locale, no printf and no heap allocation
+ *
+ * Two formats, each byte-for-byte what the library produced before:
+ *   Number_text(x)                 std::to_string(x): "%d", or "%f" (six
+ *                                  decimals) for a double; gpl's string
+ *                                  conversions (as_string(), "a" + 1.5)
+ *   Number_text(x, Number_text::STREAM)
+ *                                  what a default std::ostream writes for
+ *                                  x: "%g" with precision 6; the symbol
+ *                                  table dump
+ */
+
+#ifndef NUMBER_FORMAT_H
+#define NUMBER_FORMAT_H
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace gamelang {
+
+  class Number_text {
+    public:
+      enum Format { TO_STRING, STREAM };
+
+      explicit Number_text(int value);
+      explicit Number_text(double value, Format format = TO_STRING);
+
+      std::string_view view() const { return std::string_view(text, length); }
+      std::string str() const { return std::string(text, length); }
+
+    private:
+      // "%f" of -DBL_MAX is 317 characters
+      char text[320];
+      int length;
+  };
+
+  std::ostream& operator<<(std::ostream& os, const Number_text& number);
+
+  // std::string(Number_text(value).view()), for callers that need a string
+  template <typename Number>
+  std::string number_to_string(Number value) {
+    return Number_text(value).str();
+  }
+}
+#endif
@@ -1,4 +1,5 @@
 #include "scope_man.h"
+#include "intern_pool.h"
 #include <sstream>
 
 Scope_manager::Scope_manager() {
@@ -8,10 +9,17 @@ Scope_manager::Scope_manager() {
 // Push a new symbol table (new scope)
 void Scope_manager::push_table() {
     tables.push_back(std::make_unique<Symbol_table>());
+    undo_marks.push_back(undo_log.size());
 }
 
 void Scope_manager::pop_table() {
     if (tables.size() > 1) {
+        // restore the bindings this scope's declarations shadowed
+        while (undo_log.size() > undo_marks.back()) {
+            bindings[undo_log.back().id] = undo_log.back().symbol;
+            undo_log.pop_back();
+        }
+        undo_marks.pop_back();
         tables.pop_back();
     } else {
         throw std::underflow_error("Can't pop global symbol table");
@@ -19,23 +27,40 @@ void Scope_manager::pop_table() {
 }
 
 bool Scope_manager::add_to_current_scope(Symbol* sym) {
-    return tables.back()->insert(sym);
+    if (!tables.back()->insert(sym)) {
+        return false;
+    }
+    int id = sym->get_id();
+    if (id >= static_cast<int>(bindings.size())) {
+        bindings.resize(id + 1, nullptr);
+    }
+    undo_log.push_back(Shadowed{id, bindings[id]});
+    bindings[id] = sym;
+    return true;
 }
 
 Symbol* Scope_manager::lookup(const std::string& name) {
-    for (auto it = tables.rbegin(); it != tables.rend(); ++it) {
-        Symbol* sym = (*it)->lookup(name);
-        if (sym) {
-            return sym;
-        }
+    // a name that was never interned was never declared
+    int id = identifiers.find(name);
+    if (id == Intern_pool::NOT_FOUND) {
+        return nullptr;
     }
-    return nullptr;
+    return lookup(id);
+}
+
+Symbol* Scope_manager::lookup(int id) {
+    return (id >= 0 && id < static_cast<int>(bindings.size()))
+        ? bindings[id] : nullptr;
 }
 
 bool Scope_manager::defined_in_current_scope(const std::string& name) {
     return tables.back()->lookup(name) != nullptr;
 }
 
+bool Scope_manager::defined_in_current_scope(int id) {
+    return tables.back()->lookup(id) != nullptr;
+}
+
 std::ostream& operator<<(std::ostream& os, const Scope_manager& sm) {
     for (auto it = sm.tables.rbegin(); it != sm.tables.rend(); ++it) {
         os << **it;
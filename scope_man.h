@@ -7,6 +7,17 @@
 #include <iostream>
 #include "symbol_table.h"
 
+// Scope_manager keeps one Symbol_table per open scope, which owns the
+// scope's symbols and is what gets printed.  Lookups don't search the
+// tables: bindings holds, for every interned name, the innermost symbol
+// with that name, so a lookup is one index no matter how deep the scopes
+// are nested.  Declaring a symbol pushes the binding it shadows onto
+// undo_log; pop_table() puts those back.
+//
+// pop_table() leaves the popped scope's elements in symbol_storage.  The
+// Statement_blocks and Bytecodes compiled while it was open hold their
+// offsets and run after the parse, so the offsets are never handed out
+// again.
 class Scope_manager {
 public:
     Scope_manager(); 
@@ -15,12 +26,22 @@ public:
     void pop_table();
     bool add_to_current_scope(Symbol* sym);
     Symbol* lookup(const std::string& name);
+    Symbol* lookup(int id);     // id from identifiers (intern_pool.h)
     bool defined_in_current_scope(const std::string& name);
+    bool defined_in_current_scope(int id);
 
     friend std::ostream& operator<<(std::ostream& os, const Scope_manager& sm);
 
 private:
     std::vector<std::unique_ptr<Symbol_table>> tables;
+    std::vector<Symbol*> bindings;  // indexed by id; nullptr if unbound
+    struct Shadowed {
+        int id;
+        Symbol* symbol;
+    };
+    std::vector<Shadowed> undo_log;
+    // undo_log's size when each nested scope was pushed
+    std::vector<size_t> undo_marks;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "source_buffer.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Source_buffer source_buffer;
+
+Source_buffer::~Source_buffer() {
+    unmap();
+}
+
+bool Source_buffer::map(const std::string& filename) {
+    unmap();
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return false;
+    }
+
+    // Reserve the file plus the two '\0' bytes as zeroed anonymous memory,
+    // then map the file over the front of it.  The bytes after the end of
+    // the file are then always zero, even when the file ends exactly on a
+    // page boundary.
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t length = info.st_size + 2;
+    size_t reserved = (length + page - 1) / page * page;
+    void* region = mmap(nullptr, reserved, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    if (info.st_size > 0
+        && mmap(region, info.st_size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(region, reserved);
+        close(fd);
+        return false;
+    }
+    close(fd);
+
+    base = static_cast<char*>(region);
+    file_size = info.st_size;
+    mapped_size = reserved;
+    return true;
+}
+
+void Source_buffer::unmap() {
+    copies.clear();
+    if (base) {
+        munmap(base, mapped_size);
+        base = nullptr;
+        file_size = mapped_size = 0;
+    }
+}
+
+Source_slice Source_buffer::slice(const char* text, int length) {
+    if (base && text >= base && text + length <= base + file_size) {
+        return Source_slice{text, length};
+    }
+    copies.emplace_back(text, length);
+    return Source_slice{copies.back().data(), length};
+}
+
+void Source_buffer::release(const Source_slice& slice) {
+    // slices are released in the order the lexer made them, so the copy,
+    // if there is one, is almost always the oldest
+    for (auto it = copies.begin(); it != copies.end(); ++it) {
+        if (it->data() == slice.text) {
+            copies.erase(it);
+            return;
+        }
+    }
+}
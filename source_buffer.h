@@ -0,0 +1,62 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <string_view>
+
+// A Source_slice is a run of characters in the program text.  It is a
+// plain struct so it can live in the parser's %union.
+struct Source_slice {
+    const char* text;
+    int length;
+
+    std::string_view view() const { return std::string_view(text, length); }
+};
+
+// Source_buffer maps a script file into memory so the scanner can run over
+// it in place (yy_scan_buffer) instead of copying it through yyin.  The
+// mapping is private and writable because flex writes a '\0' after each
+// token while it is being matched; the kernel only copies the pages that
+// are touched.
+//
+// slice() hands the lexer a Source_slice for token text.  Text inside the
+// mapping is used as is; text anywhere else (flex's own buffer when
+// reading through yyin, which it reuses) is copied first.  The parser
+// release()s a slice once it has its own copy of the text (the literal
+// pool's), which frees such a copy; unmap() frees any still held, when
+// the slices into the mapping become invalid too.
+class Source_buffer {
+public:
+    Source_buffer() = default;
+    ~Source_buffer();
+
+    // map filename followed by the two '\0' bytes flex requires at the end
+    // of a scan buffer; false if the file can't be opened or mapped
+    bool map(const std::string& filename);
+    void unmap();
+    bool is_mapped() const { return base != nullptr; }
+
+    // the mapping as yy_scan_buffer() wants it: the file, then two '\0'
+    char* data() { return base; }
+    size_t size() const { return file_size + 2; }
+
+    Source_slice slice(const char* text, int length);
+    void release(const Source_slice& slice);
+
+    Source_buffer(const Source_buffer&) = delete;
+    Source_buffer& operator=(const Source_buffer&) = delete;
+
+private:
+    char* base = nullptr;
+    size_t file_size = 0;
+    size_t mapped_size = 0;
+    std::list<std::string> copies;  // slices from outside the mapping, until
+                                    // released; a list so freeing one leaves
+                                    // the others where they are
+};
+
+extern Source_buffer source_buffer;
+
+#endif
@@ -0,0 +1,363 @@
+//File: statement_block.cpp
+#include "statement_block.h"
+#include "array_assignment.h"
+#include "Bytecode.h"
+#include "Constant.h"
+#include "Expression.h"
+#include "error.h"
+#include "symbol.h"
+#include "symbol_storage.h"
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+Statement_block::Statement_block(Kind kind) : kind(kind) {}
+
+Statement_block::~Statement_block()
+{
+  for (const Expression* expr : owned)
+    Expression::destroy(expr);
+}
+
+template <typename T>
+T* Statement_block::slot(const Instruction& assignment)
+{
+  int offset = assignment.offset;
+  if (assignment.variable) {
+    int element = assignment.index ? Statement_block::element(assignment)
+                                   : assignment.variable->element();
+    if (element < 0)
+      return nullptr;
+    offset += element;
+  }
+  if constexpr (std::is_same_v<T, int>)
+    return symbol_storage.ints() + offset;
+  else if constexpr (std::is_same_v<T, double>)
+    return symbol_storage.doubles() + offset;
+  else
+    return symbol_storage.strings() + offset;
+}
+
+// the array element an assignment stores to, as Variable::element() but
+// with the index run from its Bytecode
+int Statement_block::element(const Instruction& assignment)
+{
+  Bytecode& index = *assignment.index;
+  const Variable* variable = assignment.variable;
+  if (!index.execute())
+    return variable->element(Value());
+  if (index.type() == gamelang::INT) {
+    int i = index.int_result();
+    if (variable->index_proven()
+        || (i >= 0 && i < variable->get_symbol()->get_count()))
+      return i;
+  }
+  return variable->element(index.result());
+}
+
+// as Expression::evaluate_bool()
+bool Statement_block::truth(Bytecode& condition)
+{
+  if (!condition.execute())
+    return false;
+  switch (condition.type()) {
+    case gamelang::INT:    return condition.int_result() != 0;
+    case gamelang::DOUBLE: return condition.double_result() != 0.0;
+    default:               return false;
+  }
+}
+
+std::optional<int> Statement_block::execute() const
+{
+  const Instruction* start = code.data();
+  const Instruction* pc = start;
+  for (;;) {
+    switch (pc->op) {
+      case END:
+        return std::nullopt;
+      case JUMP:
+        pc = start + pc->target;
+        break;
+      case JUMP_IF_FALSE:
+        pc = truth(*pc->code) ? pc + 1 : start + pc->target;
+        break;
+      case JUMP_IF_TRUE:
+        pc = truth(*pc->code) ? start + pc->target : pc + 1;
+        break;
+      case INT_ASSIGN:
+      case INT_PLUS_ASSIGN:
+      case INT_MINUS_ASSIGN:
+        if (int* element = slot<int>(*pc)) {
+          if (pc->code->execute()) {
+            int v = pc->code->int_result();
+            *element = pc->op == INT_ASSIGN ? v
+                     : pc->op == INT_PLUS_ASSIGN ? *element + v : *element - v;
+          }
+        }
+        pc++;
+        break;
+      case INT_STEP:
+        if (int* element = slot<int>(*pc))
+          *element += pc->step;
+        pc++;
+        break;
+      case DBL_ASSIGN:
+      case DBL_PLUS_ASSIGN:
+      case DBL_MINUS_ASSIGN:
+        if (double* element = slot<double>(*pc)) {
+          if (pc->code->execute()) {
+            double v = pc->code->double_result();
+            *element = pc->op == DBL_ASSIGN ? v
+                     : pc->op == DBL_PLUS_ASSIGN ? *element + v : *element - v;
+          }
+        }
+        pc++;
+        break;
+      case STR_ASSIGN:
+        if (std::string* element = slot<std::string>(*pc)) {
+          if (pc->code->execute())
+            element->assign(pc->code->string_result());
+        }
+        pc++;
+        break;
+      case STR_APPEND:
+        // the value is built in its register before it is appended, so it
+        // may read the variable it appends to (s += "a" + s)
+        if (std::string* element = slot<std::string>(*pc)) {
+          if (pc->code->execute())
+            element->append(pc->code->string_result());
+        }
+        pc++;
+        break;
+      case ARRAY_ASSIGN:
+        array_assignments[pc->target]->execute();
+        pc++;
+        break;
+      case PRINT:
+        if (pc->code->execute())
+          std::cout << "print[" << pc->line << "]: " << pc->code->string_result()
+                    << std::endl;
+        pc++;
+        break;
+      case EXIT:
+        return pc->code->execute() ? pc->code->int_result() : 0;
+    }
+  }
+}
+
+void Statement_builder::begin_block(Statement_block::Kind kind)
+{
+  assert(!block);
+  block = std::make_unique<Statement_block>(kind);
+}
+
+void Statement_builder::end_block()
+{
+  assert(block && loops.empty());
+  emit(Statement_block::END);
+  finished.push_back(std::move(block));
+}
+
+int Statement_builder::emit(Statement_block::Opcode op, const Expression* expr,
+                            gamelang::Type as, int line)
+{
+  block->code.push_back(Statement_block::Instruction{op, 0, line, 0, 0,
+                                                     compile(expr, as), nullptr, nullptr});
+  return block->code.size() - 1;
+}
+
+Bytecode* Statement_builder::compile(const Expression* expr, gamelang::Type as)
+{
+  if (!expr)
+    return nullptr;
+  block->bytecodes.push_back(std::make_unique<Bytecode>(expr, as));
+  return block->bytecodes.back().get();
+}
+
+void Statement_builder::own(const Expression* expr)
+{
+  if (expr)
+    block->owned.push_back(expr);
+}
+
+void Statement_builder::assign(const Assignment_form& assignment)
+{
+  const Variable* variable = assignment.target;
+  const Expression* value = assignment.value;
+  if (assignment.kind == Assignment_form::NONE)
+    return;
+  own(variable);
+  own(value);
+
+  // nothing evaluates the target of a statement that is not compiled, so
+  // the reason it is not is reported here
+  const std::string& name = variable->get_symbol_name();
+  const Symbol* symbol = variable->get_symbol();
+  if (!symbol) {
+    if (!name.empty())  // empty for a member, which has no symbol yet
+      gamelang::error(gamelang::UNDECLARED_VARIABLE,
+                      variable->get_index_expression() ? name + "[]" : name);
+    return;
+  }
+  gamelang::Type type = symbol->get_type();
+  gamelang::Type value_type = value ? value->type() : gamelang::NO_TYPE;
+
+  if (symbol->get_count() > 1 && variable->is_whole_array_reference()) {
+    std::unique_ptr<Array_assignment> array_assignment;
+    if (assignment.kind == Assignment_form::ASSIGN)
+      array_assignment = Array_assignment::compile(symbol, value);
+    if (!array_assignment) {
+      gamelang::error(gamelang::VARIABLE_IS_AN_ARRAY, name);
+      return;
+    }
+    int at = emit(Statement_block::ARRAY_ASSIGN);
+    block->code[at].target = block->array_assignments.size();
+    block->array_assignments.push_back(std::move(array_assignment));
+    return;
+  }
+
+  // the opcode for the target's type, or END once the types that do not
+  // fit are reported
+  Statement_block::Opcode op = Statement_block::END;
+  bool value_fits = gamelang::converts_to(value_type, type);
+  std::string type_name = gamelang::to_string(type);
+  std::string value_type_name = gamelang::to_string(value_type);
+  auto literal = dynamic_cast<const Constant*>(value);
+  bool int_literal = literal && value_type == gamelang::INT;
+  int step = 0;
+  switch (assignment.kind) {
+    case Assignment_form::ASSIGN:
+      if (!value_fits)
+        gamelang::error(gamelang::ASSIGNMENT_TYPE_ERROR, type_name, value_type_name);
+      else
+        op = type == gamelang::INT    ? Statement_block::INT_ASSIGN
+           : type == gamelang::DOUBLE ? Statement_block::DBL_ASSIGN
+           :                            Statement_block::STR_ASSIGN;
+      break;
+    case Assignment_form::PLUS_ASSIGN:
+      if (!value_fits) {
+        gamelang::error(gamelang::PLUS_ASSIGNMENT_TYPE_ERROR, type_name, value_type_name);
+        break;
+      }
+      if (type == gamelang::INT && int_literal) {
+        op = Statement_block::INT_STEP;
+        step = literal->as_int();
+      }
+      else if (type == gamelang::STRING)
+        op = Statement_block::STR_APPEND;
+      else
+        op = type == gamelang::INT ? Statement_block::INT_PLUS_ASSIGN
+                                   : Statement_block::DBL_PLUS_ASSIGN;
+      break;
+    case Assignment_form::MINUS_ASSIGN:
+      if (type == gamelang::STRING) {
+        gamelang::error(gamelang::INVALID_LHS_OF_MINUS_ASSIGNMENT, name, type_name);
+        break;
+      }
+      if (!value_fits) {
+        gamelang::error(gamelang::MINUS_ASSIGNMENT_TYPE_ERROR, type_name, value_type_name);
+        break;
+      }
+      if (type == gamelang::INT && int_literal
+          && literal->as_int() != std::numeric_limits<int>::min()) {
+        op = Statement_block::INT_STEP;
+        step = -literal->as_int();
+      }
+      else
+        op = type == gamelang::INT ? Statement_block::INT_MINUS_ASSIGN
+                                   : Statement_block::DBL_MINUS_ASSIGN;
+      break;
+    case Assignment_form::PLUS_PLUS:
+    case Assignment_form::MINUS_MINUS:
+      if (type != gamelang::INT) {
+        gamelang::error(assignment.kind == Assignment_form::PLUS_PLUS
+                          ? gamelang::INVALID_LHS_OF_PLUS_PLUS
+                          : gamelang::INVALID_LHS_OF_MINUS_MINUS,
+                        name, type_name);
+        break;
+      }
+      op = Statement_block::INT_STEP;
+      step = assignment.kind == Assignment_form::PLUS_PLUS ? 1 : -1;
+      break;
+    default:
+      break;
+  }
+  if (op == Statement_block::END)
+    return;
+  // a scalar is bound to its element here; only an indexed target is
+  // looked at when the assignment runs, its index through a Bytecode if
+  // it is an array (an index on a scalar is reported by element())
+  int at = emit(op, value, type);
+  Statement_block::Instruction& instruction = block->code[at];
+  instruction.offset = symbol->get_offset();
+  instruction.step = step;
+  if (const Expression* index = variable->get_index_expression()) {
+    instruction.variable = variable;
+    if (symbol->get_count() > 1)
+      instruction.index = compile(index, gamelang::NO_TYPE);
+  }
+}
+
+void Statement_builder::print(const Expression* expr, int line)
+{
+  own(expr);
+  gamelang::Type type = expr->type();
+  auto variable = dynamic_cast<const Variable*>(expr);
+  bool whole_array = variable && variable->get_symbol()
+    && variable->get_symbol()->get_count() > 1 && variable->is_whole_array_reference();
+  if (whole_array)
+    gamelang::error(gamelang::VARIABLE_IS_AN_ARRAY, variable->get_symbol_name());
+  else if (!gamelang::converts_to(type, gamelang::STRING))
+    gamelang::error(gamelang::INVALID_TYPE_FOR_PRINT_STMT_EXPRESSION);
+  else
+    emit(Statement_block::PRINT, expr, gamelang::STRING, line);
+}
+
+void Statement_builder::exit(const Expression* expr, int line)
+{
+  own(expr);
+  if (expr->type() != gamelang::INT)
+    gamelang::error(gamelang::EXIT_STATUS_MUST_BE_AN_INTEGER,
+                    gamelang::to_string(expr->type()));
+  else
+    emit(Statement_block::EXIT, expr, gamelang::INT, line);
+}
+
+int Statement_builder::begin_if(const Expression* condition)
+{
+  own(condition);
+  return emit(Statement_block::JUMP_IF_FALSE, condition);
+}
+
+int Statement_builder::begin_else(int if_jump)
+{
+  int jump = emit(Statement_block::JUMP);
+  end_if(if_jump);
+  return jump;
+}
+
+void Statement_builder::end_if(int jump)
+{
+  block->code[jump].target = block->code.size();
+}
+
+void Statement_builder::begin_for(const Assignment_form& init, const Expression* condition,
+                                  const Assignment_form& update)
+{
+  assign(init);
+  own(condition);
+  loops.push_back(Loop{emit(Statement_block::JUMP), condition, update});
+}
+
+void Statement_builder::end_for()
+{
+  Loop loop = loops.back();
+  loops.pop_back();
+  int top = loop.jump_to_test + 1;
+  assign(loop.update);
+  block->code[loop.jump_to_test].target = block->code.size();
+  int test = emit(Statement_block::JUMP_IF_TRUE, loop.condition);
+  block->code[test].target = top;
+}
@@ -0,0 +1,178 @@
+//File: statement_block.h
+#ifndef STATEMENT_BLOCK_H
+#define STATEMENT_BLOCK_H
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Value.h"
+#include "loop_bounds.h"
+
+class Array_assignment;
+class Bytecode;
+class Expression;
+class Variable;
+
+// A Statement_block is the executable form of an initialization,
+// termination, animation or on block: its statements, nested ones
+// included, flattened into one list of instructions.  if and for become
+// conditional jumps whose targets are instruction indexes fixed when the
+// block is built, so execute() is one loop over the list with a switch on
+// the opcode, not a walk of a statement tree through virtual calls.
+//
+//     for (i = 0; i < n; i += 1) body      if (c) s1 else s2
+//
+//         i = 0                                JUMP_IF_FALSE c, else
+//         JUMP test                            s1
+//     top:                                     JUMP end
+//         body                             else:
+//         i += 1                               s2
+//     test:                                end:
+//         JUMP_IF_TRUE i < n, top
+//
+// The test of a for loop sits after its body, so every iteration takes a
+// single branch.  An assignment to a whole array is compiled to an
+// Array_assignment (array_assignment.h) when its expression allows.
+//
+// Every expression of a statement (a value, a condition, what is printed)
+// is compiled to a Bytecode when its instruction is built, converted to
+// the type the instruction wants, so execute() never walks a tree.  Other
+// assignments are bound to their target's storage then too: the
+// instruction holds the offset of the symbol's elements in symbol_storage,
+// which never changes, and has an opcode for the type of the target, so
+// running it updates the int, double or string in place without looking
+// the symbol up or building a value for the target.  An array element's
+// index is compiled to a Bytecode of its own and run first.  ++, -- and +=
+// or -= a literal on an int are one INT_STEP that adds a step held in the
+// instruction.  A string += appends its value straight onto the variable,
+// reusing its capacity.
+//
+// A statement whose types do not fit (a string assigned to an int, ++ on
+// a double, print of a whole array, an assignment to a whole array that
+// Array_assignment cannot run, ...) is reported as a semantic error when
+// it is built and is not compiled into the block.
+//
+// A block owns the expressions and variables of its statements.
+class Statement_block {
+  public:
+    enum Kind { INITIALIZATION, TERMINATION, ANIMATION, ON };
+
+    explicit Statement_block(Kind kind);
+    ~Statement_block();
+
+    Kind get_kind() const { return kind; }
+    int size() const { return code.size(); }
+
+    // runs the block; the status of the exit statement that stopped it,
+    // if one did
+    std::optional<int> execute() const;
+
+    Statement_block(const Statement_block&) = delete;
+    Statement_block& operator=(const Statement_block&) = delete;
+
+    enum Opcode : unsigned char {
+      END,
+      JUMP,              // to target
+      JUMP_IF_FALSE,     // to target unless expr is true
+      JUMP_IF_TRUE,      // to target if expr is true
+      // assignments, by the type of the variable assigned
+      INT_ASSIGN,        // variable = expr
+      INT_PLUS_ASSIGN,   // variable += expr
+      INT_MINUS_ASSIGN,  // variable -= expr
+      INT_STEP,          // variable += step: ++, --, += or -= a literal
+      DBL_ASSIGN,
+      DBL_PLUS_ASSIGN,
+      DBL_MINUS_ASSIGN,
+      STR_ASSIGN,
+      STR_APPEND,        // variable += expr, appended straight onto variable
+      ARRAY_ASSIGN,      // array_assignments[target]
+      PRINT,             // print(expr) from line
+      EXIT               // exit(expr) from line
+    };
+
+  private:
+    friend class Statement_builder;
+
+    struct Instruction {
+      Opcode op;
+      int target;                 // jumps: an index into code
+      int line;                   // PRINT, EXIT
+      int offset;                 // assignments: the variable's first element
+                                  // in symbol_storage
+      int step;                   // INT_STEP
+      Bytecode* code;             // value, condition, printed or exit status
+      Bytecode* index;            // assignments to an array element: its index
+      const Variable* variable;   // assignments to an element
+    };
+
+    // the int, double or string an assignment updates, or nullptr once
+    // the reason there isn't one has been reported
+    template <typename T>
+    static T* slot(const Instruction& assignment);
+    static int element(const Instruction& assignment);
+    static bool truth(Bytecode& condition);
+
+    Kind kind;
+    std::vector<Instruction> code;
+    std::vector<std::unique_ptr<Array_assignment>> array_assignments;
+    std::vector<std::unique_ptr<Bytecode>> bytecodes;  // the instructions'
+    std::vector<const Expression*> owned;   // destroyed with the block
+};
+
+// Statement_builder builds the Statement_blocks as the parser reduces
+// their statements, which it does in source order, so each statement is
+// appended to the block being built as soon as it is complete:
+//   begin_block()              before a block's statements
+//   assign(), print(), exit()  for each simple statement
+//   begin_if()                 after if (condition), returning the jump
+//   begin_else()               after the then statement; give it the jump
+//                              from begin_if() and it returns the next
+//   end_if()                   after the last statement of the if, with
+//                              the jump from begin_if() or begin_else()
+//   begin_for()                after the for header
+//   end_for()                  after the body
+//   end_block()                after the block; it is then in blocks()
+class Statement_builder {
+  public:
+    Statement_builder() = default;
+
+    void begin_block(Statement_block::Kind kind);
+    void end_block();
+
+    void assign(const Assignment_form& assignment);
+    void print(const Expression* expr, int line);
+    void exit(const Expression* expr, int line);
+    int begin_if(const Expression* condition);
+    int begin_else(int if_jump);
+    void end_if(int jump);
+    void begin_for(const Assignment_form& init, const Expression* condition,
+                   const Assignment_form& update);
+    void end_for();
+
+    const std::vector<std::unique_ptr<Statement_block>>& blocks() const { return finished; }
+
+    Statement_builder(const Statement_builder&) = delete;
+    Statement_builder& operator=(const Statement_builder&) = delete;
+
+  private:
+    struct Loop {
+      int jump_to_test;
+      const Expression* condition;
+      Assignment_form update;
+    };
+
+    // the instruction, with expr compiled and converted to as
+    int emit(Statement_block::Opcode op, const Expression* expr = nullptr,
+             gamelang::Type as = gamelang::NO_TYPE, int line = 0);
+    Bytecode* compile(const Expression* expr, gamelang::Type as);
+    void own(const Expression* expr);
+
+    std::unique_ptr<Statement_block> block;   // being built
+    std::vector<Loop> loops;                  // for statements being built
+    std::vector<std::unique_ptr<Statement_block>> finished;
+};
+
+// Defined in gpl.y after ast_arena, so its blocks are destroyed first.
+extern Statement_builder statement_builder;
+
+#endif
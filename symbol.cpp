@@ -1,56 +1,29 @@
 #include "symbol.h"
+#include "number_format.h"
 #include <cassert>
 
-Symbol::Symbol(const std::string& name, double* val) : name(name), type(gamelang::DOUBLE), count(1) {
-    value.double_pointer = val;
+Symbol::Symbol(int id, int value)
+    : id(id), type(gamelang::INT), count(1),
+      offset(symbol_storage.allocate(gamelang::INT, 1)) {
+    *int_values() = value;
 }
 
-Symbol::Symbol(const std::string& name, double* array, int count) : name(name), type(gamelang::DOUBLE), count(count) {
-    value.double_pointer = array;
+Symbol::Symbol(int id, double value)
+    : id(id), type(gamelang::DOUBLE), count(1),
+      offset(symbol_storage.allocate(gamelang::DOUBLE, 1)) {
+    *double_values() = value;
 }
 
-Symbol::Symbol(const std::string& name, int* val) : name(name), type(gamelang::INT), count(1) {
-    value.int_pointer = val;
+Symbol::Symbol(int id, const std::string& value)
+    : id(id), type(gamelang::STRING), count(1),
+      offset(symbol_storage.allocate(gamelang::STRING, 1)) {
+    *string_values() = value;
 }
 
-Symbol::Symbol(const std::string& name, int* array, int count) : name(name), type(gamelang::INT), count(count) {
-    value.int_pointer = array;
-}
-
-Symbol::Symbol(const std::string& name, std::string* val) : name(name), type(gamelang::STRING), count(1) {
-    value.string_pointer = val;
-}
-
-Symbol::Symbol(const std::string& name, std::string* array, int count) : name(name), type(gamelang::STRING), count(count) {
-    value.string_pointer = array;
-}
-
-Symbol::~Symbol() {
-    if (count <= 0) return;  
-    
-    switch (type) {
-        case gamelang::DOUBLE:
-            if (value.double_pointer) {
-                count > 1 ? delete[] value.double_pointer : delete value.double_pointer;
-                value.double_pointer = nullptr;  
-            }
-            break;
-        case gamelang::INT:
-        if (value.int_pointer) {
-            count > 1 ? delete[] value.int_pointer : delete value.int_pointer;
-            value.int_pointer = nullptr;  
-        }
-        break;
-        case gamelang::STRING:
-        if (value.string_pointer) {
-            count > 1 ? delete[] value.string_pointer : delete value.string_pointer;
-            value.string_pointer = nullptr;  
-        }
-        break;
-        default:
-            assert(false);
-    }
-}
+Symbol::Symbol(int id, gamelang::Type type, int count,
+               Symbol_storage::Initial initial)
+    : id(id), type(type), count(count),
+      offset(symbol_storage.allocate(type, count, initial)) {}
 
 std::ostream& operator<<(std::ostream& os, const Symbol& sym) {
     auto print_type = [&os, &sym]() {
@@ -72,16 +45,17 @@ std::ostream& operator<<(std::ostream& os, const Symbol& sym) {
     // For a scalar symbol
     if (sym.count == 1) {
         print_type();
-        os << " " << sym.name << " = ";
+        os << " " << sym.get_name() << " = ";
         switch(sym.type) {
             case gamelang::INT:
-                os << *sym.value.int_pointer;
+                os << gamelang::Number_text(*sym.int_values());
                 break;
             case gamelang::DOUBLE:
-                os << *sym.value.double_pointer;
+                os << gamelang::Number_text(*sym.double_values(),
+                                            gamelang::Number_text::STREAM);
                 break;
             case gamelang::STRING:
-                os << "\"" << *sym.value.string_pointer << "\"";
+                os << "\"" << *sym.string_values() << "\"";
                 break;
             default:
                 assert(false); // Unexpected type
@@ -91,16 +65,17 @@ std::ostream& operator<<(std::ostream& os, const Symbol& sym) {
     else {
         for (int i = 0; i < sym.count; ++i) {
             print_type();
-            os << " " << sym.name << "[" << i << "] = ";
+            os << " " << sym.get_name() << "[" << i << "] = ";
             switch(sym.type) {
                 case gamelang::INT:
-                    os << sym.value.int_pointer[i];
+                    os << gamelang::Number_text(sym.int_values()[i]);
                     break;
                 case gamelang::DOUBLE:
-                    os << sym.value.double_pointer[i];
+                    os << gamelang::Number_text(sym.double_values()[i],
+                                                gamelang::Number_text::STREAM);
                     break;
                 case gamelang::STRING:
-                    os << "\"" << sym.value.string_pointer[i] << "\"";
+                    os << "\"" << sym.string_values()[i] << "\"";
                     break;
                 default:
                     assert(false);
@@ -112,32 +87,34 @@ std::ostream& operator<<(std::ostream& os, const Symbol& sym) {
     return os;
 }
 
-const Constant* Symbol::as_constant() const {
-    if (count != 1) return nullptr;
+Value Symbol::as_value() const {
+    if (count != 1) return Value();
 
     switch (type) {
         case gamelang::INT:
-            return new Integer_constant(*value.int_pointer);
+            return Value(*int_values());
         case gamelang::DOUBLE:
-            return new Double_constant(*value.double_pointer);
+            return Value(*double_values());
         case gamelang::STRING:
-            return new String_constant(*value.string_pointer);
+            return Value(*string_values());
         default:
-            throw type; // New types like RECTANGLE will trigger this
+            assert(false);
+            return Value();
     }
 }
 
-const Constant* Symbol::as_constant(int index) const {
-    if (index < 0 || index >= count) return nullptr;
+Value Symbol::as_value(int index) const {
+    if (index < 0 || index >= count) return Value();
 
     switch (type) {
         case gamelang::INT:
-            return new Integer_constant(value.int_pointer[index]);
+            return Value(int_values()[index]);
         case gamelang::DOUBLE:
-            return new Double_constant(value.double_pointer[index]);
+            return Value(double_values()[index]);
         case gamelang::STRING:
-            return new String_constant(value.string_pointer[index]);
+            return Value(string_values()[index]);
         default:
-            throw type;
+            assert(false);
+            return Value();
     }
-}
\ No newline at end of file
+}
@@ -6,40 +6,47 @@
 #include <unordered_map>
 #include <memory>
 #include "types_and_ops.h"
+#include "symbol_storage.h"
+#include "intern_pool.h"
+#include "arena.h"
 #include "Constant.h"
 
+// A Symbol names count elements of one type in symbol_storage.  It holds
+// no value itself: its elements start at get_offset() in the storage
+// vector for its type.  Its name is an id in identifiers (intern_pool.h).
 class Symbol {
 private:
-    std::string name;
+    int id;
     gamelang::Type type;
     int count;
-    
-    union symbol_type {
-        double* double_pointer;
-        int* int_pointer;
-        std::string* string_pointer;
-
-        symbol_type(double* val) : double_pointer(val) {}
-        symbol_type(int* val) : int_pointer(val) {}
-        symbol_type(std::string* val) : string_pointer(val) {}
-        symbol_type() : double_pointer(nullptr) {}
-    } value;
+    int offset;
 
 public:
-    Symbol(const std::string& name, double* value);
-    Symbol(const std::string& name, double* value, int count);
-    Symbol(const std::string& name, int* value);
-    Symbol(const std::string& name, int* value, int count);
-    Symbol(const std::string& name, std::string* value);
-    Symbol(const std::string& name, std::string* value, int count);
-    ~Symbol();
+    // symbols are allocated from ast_arena (arena.h)
+    ARENA_ALLOCATED
+
+    Symbol(int id, int value);
+    Symbol(int id, double value);
+    Symbol(int id, const std::string& value);
+    // an array; its elements start as initial says (symbol_storage.h),
+    // or use int_values() etc. to initialize them
+    Symbol(int id, gamelang::Type type, int count,
+           Symbol_storage::Initial initial = Symbol_storage::ZERO);
+    ~Symbol() = default;
 
     gamelang::Type get_type() const { return type; }
-    std::string get_name() const { return name; }
+    const std::string& get_name() const { return identifiers.name(id); }
+    int get_id() const { return id; }
     int get_count() const { return count; }
+    int get_offset() const { return offset; }
+
+    // the symbol's elements; see Symbol_storage for how long these are valid
+    int* int_values() const { return symbol_storage.ints() + offset; }
+    double* double_values() const { return symbol_storage.doubles() + offset; }
+    std::string* string_values() const { return symbol_storage.strings() + offset; }
 
-    const Constant* as_constant() const;
-    const Constant* as_constant(int index) const;
+    Value as_value() const;
+    Value as_value(int index) const;
 
     friend std::ostream& operator<<(std::ostream& os, const Symbol& sym);
     
@@ -48,12 +55,12 @@ public:
     bool is_valid() const {
         if (count <= 0) return false;
         switch(type) {
-            case gamelang::DOUBLE: return value.double_pointer != nullptr;
-            case gamelang::INT: return value.int_pointer != nullptr;
-            case gamelang::STRING: return value.string_pointer != nullptr;
+            case gamelang::DOUBLE:
+            case gamelang::INT:
+            case gamelang::STRING: return true;
             default: return false;
         }
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,117 @@
+#include "symbol_storage.h"
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <thread>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+Symbol_storage symbol_storage;
+
+namespace {
+
+// element i = i, four at a time
+void fill_indexes(int* values, int count) {
+    int i = 0;
+#ifdef __SSE2__
+    __m128i next = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i step = _mm_set1_epi32(4);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), next);
+        next = _mm_add_epi32(next, step);
+    }
+#endif
+    for (; i < count; i++) values[i] = i;
+}
+
+// element i = i + 0.5, two at a time (exact: every i + 0.5 is a double)
+void fill_indexes(double* values, int count) {
+    int i = 0;
+#ifdef __SSE2__
+    __m128d next = _mm_setr_pd(0.5, 1.5);
+    const __m128d step = _mm_set1_pd(2.0);
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(values + i, next);
+        next = _mm_add_pd(next, step);
+    }
+#endif
+    for (; i < count; i++) values[i] = i + 0.5;
+}
+
+void format_indexes(std::string* values, int begin, int end) {
+    char text[16];
+    for (int i = begin; i < end; i++) {
+        char* last = std::to_chars(text, text + sizeof text, i).ptr;
+        values[i].assign(text, last);
+    }
+}
+
+// element i = to_string(i).  The strings were all constructed by one
+// resize() and no index has more digits than fit in a string's own
+// buffer, so this allocates nothing and a large array is split between
+// threads.
+void fill_indexes(std::string* values, int count) {
+    const int PER_THREAD = 1 << 16;
+    int threads = std::min<int>(std::thread::hardware_concurrency(), count / PER_THREAD);
+    if (threads <= 1) {
+        format_indexes(values, 0, count);
+        return;
+    }
+    std::vector<std::jthread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(format_indexes, values,
+                             int(long(count) * t / threads),
+                             int(long(count) * (t + 1) / threads));
+    }
+    format_indexes(values, 0, count / threads);
+}
+
+}
+
+int Symbol_storage::allocate(gamelang::Type type, int count, Initial initial) {
+    size_t offset = 0;
+    switch (type) {
+        case gamelang::INT:
+            offset = int_values.size();
+            int_values.resize(offset + count);
+            if (initial == INDEX) fill_indexes(int_values.data() + offset, count);
+            break;
+        case gamelang::DOUBLE:
+            offset = double_values.size();
+            double_values.resize(offset + count);
+            if (initial == INDEX) fill_indexes(double_values.data() + offset, count);
+            break;
+        case gamelang::STRING:
+            offset = string_values.size();
+            string_values.resize(offset + count);
+            if (initial == INDEX) fill_indexes(string_values.data() + offset, count);
+            break;
+        default:
+            assert(false);
+    }
+    return offset;
+}
+
+Symbol_storage::Mark Symbol_storage::mark() const {
+    return Mark{int_values.size(), double_values.size(), string_values.size()};
+}
+
+void Symbol_storage::release(const Mark& mark) {
+    int_values.resize(std::min(mark.ints, int_values.size()));
+    double_values.resize(std::min(mark.doubles, double_values.size()));
+    string_values.resize(std::min(mark.strings, string_values.size()));
+}
+
+Symbol_storage::Snapshot Symbol_storage::snapshot() const {
+    return Snapshot{int_values, double_values, string_values};
+}
+
+void Symbol_storage::restore(const Snapshot& snapshot) {
+    assert(snapshot.ints.size() == int_values.size());
+    assert(snapshot.doubles.size() == double_values.size());
+    assert(snapshot.strings.size() == string_values.size());
+    std::copy(snapshot.ints.begin(), snapshot.ints.end(), int_values.begin());
+    std::copy(snapshot.doubles.begin(), snapshot.doubles.end(), double_values.begin());
+    std::copy(snapshot.strings.begin(), snapshot.strings.end(), string_values.begin());
+}
@@ -0,0 +1,64 @@
+#ifndef SYMBOL_STORAGE_H
+#define SYMBOL_STORAGE_H
+
+#include <string>
+#include <vector>
+#include "types_and_ops.h"
+
+// Symbol_storage holds the value of every variable in the program: all of
+// the ints in one contiguous vector, all of the doubles in a second and all
+// of the strings in a third.  A Symbol only records its type (which vector)
+// and the offset and count of its elements.
+//
+// Pointers returned by ints(), doubles() and strings() are invalidated by
+// the next allocate(); offsets never are.
+class Symbol_storage {
+public:
+    Symbol_storage() = default;
+
+    // how allocate() initializes new elements: to 0, 0.0 or "", or to what
+    // element i of a newly declared array holds: i, i + 0.5 or "i"
+    enum Initial { ZERO, INDEX };
+
+    // reserve count elements of the given type and return their offset
+    int allocate(gamelang::Type type, int count, Initial initial = ZERO);
+
+    int* ints() { return int_values.data(); }
+    double* doubles() { return double_values.data(); }
+    std::string* strings() { return string_values.data(); }
+    const int* ints() const { return int_values.data(); }
+    const double* doubles() const { return double_values.data(); }
+    const std::string* strings() const { return string_values.data(); }
+
+    // a Mark is the size of each vector at some point; release() drops
+    // everything allocated since.  Only once nothing holds those offsets:
+    // a popped scope keeps its storage (scope_man.h)
+    struct Mark {
+        size_t ints;
+        size_t doubles;
+        size_t strings;
+    };
+    Mark mark() const;
+    void release(const Mark& mark);
+
+    // a copy of every variable in the program
+    struct Snapshot {
+        std::vector<int> ints;
+        std::vector<double> doubles;
+        std::vector<std::string> strings;
+    };
+    Snapshot snapshot() const;
+    void restore(const Snapshot& snapshot);
+
+    Symbol_storage(const Symbol_storage&) = delete;
+    Symbol_storage& operator=(const Symbol_storage&) = delete;
+
+private:
+    std::vector<int> int_values;
+    std::vector<double> double_values;
+    std::vector<std::string> string_values;
+};
+
+extern Symbol_storage symbol_storage;
+
+#endif
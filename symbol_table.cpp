@@ -1,33 +1,114 @@
 #include "symbol_table.h"
-#include <unordered_map>
-#include <vector>
+#include "intern_pool.h"
 #include <algorithm>
-#include <sstream>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// bit i set if group[i] == key
+unsigned match(const int* group, int key) {
+#ifdef __SSE2__
+    __m128i lanes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    __m128i equal = _mm_cmpeq_epi32(lanes, _mm_set1_epi32(key));
+    return _mm_movemask_ps(_mm_castsi128_ps(equal));
+#else
+    unsigned bits = 0;
+    for (int i = 0; i < 4; i++) {
+        if (group[i] == key) bits |= 1u << i;
+    }
+    return bits;
+#endif
+}
+
+// ids are dense, so spread them before masking: the high half of a
+// Fibonacci multiply mixes every bit of the id into every bit used
+unsigned hash(int id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(id))
+            * 0x9E3779B97F4A7C15ull) >> 32;
+}
+
+}
+
+Symbol_table::Symbol_table()
+    : keys(4 * GROUP_SIZE, EMPTY), symbols(keys.size()), count(0) {}
+
+int Symbol_table::find_slot(int id) const {
+    static_assert(GROUP_SIZE == 4, "match() compares four keys at a time");
+    unsigned group_mask = keys.size() / GROUP_SIZE - 1;
+    unsigned group = hash(id) & group_mask;
+    while (true) {
+        const int* group_keys = keys.data() + group * GROUP_SIZE;
+        if (unsigned bits = match(group_keys, id)) {
+            return group * GROUP_SIZE + __builtin_ctz(bits);
+        }
+        if (unsigned bits = match(group_keys, EMPTY)) {
+            return group * GROUP_SIZE + __builtin_ctz(bits);
+        }
+        group = (group + 1) & group_mask;
+    }
+}
+
+void Symbol_table::grow() {
+    std::vector<int> old_keys(keys.size() * 2, EMPTY);
+    std::vector<std::unique_ptr<Symbol>> old_symbols(old_keys.size());
+    old_keys.swap(keys);
+    old_symbols.swap(symbols);
+    for (size_t i = 0; i < old_keys.size(); i++) {
+        if (old_keys[i] != EMPTY) {
+            int slot = find_slot(old_keys[i]);
+            keys[slot] = old_keys[i];
+            symbols[slot] = std::move(old_symbols[i]);
+        }
+    }
+}
 
 Symbol* Symbol_table::lookup(const std::string& name) {
-    auto it = symbols.find(name);
-    return (it != symbols.end()) ? it->second.get() : nullptr;
+    int id = identifiers.find(name);
+    return (id == Intern_pool::NOT_FOUND) ? nullptr : lookup(id);
+}
+
+Symbol* Symbol_table::lookup(int id) {
+    int slot = find_slot(id);
+    return (keys[slot] == id) ? symbols[slot].get() : nullptr;
 }
 
 bool Symbol_table::insert(Symbol* sym) {
-    if (!sym || symbols.find(sym->get_name()) != symbols.end()) {
+    if (!sym) {
+        return false;
+    }
+    int slot = find_slot(sym->get_id());
+    if (keys[slot] == sym->get_id()) {
         return false;
     }
-    symbols[sym->get_name()] = std::unique_ptr<Symbol>(sym);
+    // keep at least one slot in eight empty so probes stay short
+    if ((count + 1) * 8 > static_cast<int>(keys.size()) * 7) {
+        grow();
+        slot = find_slot(sym->get_id());
+    }
+    keys[slot] = sym->get_id();
+    symbols[slot] = std::unique_ptr<Symbol>(sym);
+    count++;
     return true;
 }
 
 std::ostream& operator<<(std::ostream& os, const Symbol_table& symtab) {
-    std::vector<std::string> names;
-    for (const auto& pair : symtab.symbols) {
-        names.push_back(pair.first);
+    std::vector<const Symbol*> sorted;
+    for (const auto& sym : symtab.symbols) {
+        if (sym) {
+            sorted.push_back(sym.get());
+        }
     }
-    std::sort(names.begin(), names.end());
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Symbol* a, const Symbol* b) {
+                  return a->get_name() < b->get_name();
+              });
 
-    for (const std::string& name : names) {
-        const Symbol* sym = symtab.symbols.at(name).get();
+    for (const Symbol* sym : sorted) {
         os << *sym << std::endl;
     }
 
     return os;
-}
\ No newline at end of file
+}
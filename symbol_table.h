@@ -4,24 +4,36 @@
 #include "symbol.h"
 #include <vector>
 #include <string>
-#include <unordered_map>
-#include <algorithm>
+#include <memory>
 
+// Symbol_table is an open-addressing hash table keyed by the symbol's
+// interned id (see intern_pool.h).  Keys sit in their own array, apart
+// from the symbols, and are probed a group of GROUP_SIZE at a time, so a
+// lookup is a few int compares (one SSE2 compare per group where it is
+// available) and never touches a string.  Symbols are never removed.
 class Symbol_table {
 public:
-    Symbol_table() = default;
+    Symbol_table();
     Symbol* lookup(const std::string& name);
+    Symbol* lookup(int id);
     bool insert(Symbol* sym);
+    int size() const { return count; }
     friend std::ostream& operator<<(std::ostream& os, const Symbol_table& symtab);
 
     Symbol_table(const Symbol_table&) = delete;
     Symbol_table& operator=(const Symbol_table&) = delete;
 
-
 private:
-    std::unordered_map<std::string, std::unique_ptr<Symbol>> symbols;
-    std::vector<std::string> insertion_order;
+    static constexpr int EMPTY = -1;
+    static constexpr int GROUP_SIZE = 4;
+
+    // slot holding id, or the first empty slot along its probe sequence
+    int find_slot(int id) const;
+    void grow();
 
+    std::vector<int> keys;                        // EMPTY or an interned id
+    std::vector<std::unique_ptr<Symbol>> symbols; // parallel to keys
+    int count;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,26 @@
+# Helpers for the tests/t*.sh scripts that write tests too deep to keep in
+# the tree.  Each prints part of an expression with no final newline, so
+# a script can use it inside a here-document.
+
+# chain TERM OP N: N copies of TERM joined by OP, 40 to a line
+chain()
+{
+  awk -v term="$1" -v op="$2" -v n="$3" 'BEGIN {
+    for (i = 1; i < n; i++)
+      printf "%s%s%s", term, op, i % 40 ? "" : "\n"
+    printf "%s", term
+  }'
+}
+
+# nest LEFT INNER RIGHT N: INNER inside N levels of LEFT ... RIGHT, 40 of
+# each to a line
+nest()
+{
+  awk -v left="$1" -v inner="$2" -v right="$3" -v n="$4" 'BEGIN {
+    for (i = 1; i <= n; i++)
+      printf "%s%s", left, i % 40 ? "" : "\n"
+    printf "%s", inner
+    for (i = 1; i <= n; i++)
+      printf "%s%s", right, i % 40 || i == n ? "" : "\n"
+  }'
+}
@@ -0,0 +1,29 @@
+#!/bin/sh
+# writes t206.gpl: declarations with initial values nested far deeper
+# than the parser stack and the evaluator used to allow
+. "$(dirname "$0")/chains.sh"
+
+cat <<END
+// declarations with initial values nested far deeper than the parser
+// stack and the evaluator used to allow; each must still be evaluated
+
+int a = 1;
+double h = 0.5;
+string e;
+
+// a left-deep chain of 60000 additions
+int sum =
+$(chain a + 60000);
+
+// 25000 levels of parentheses, nested to the right
+int nested =
+$(nest 'a-(' a ')' 25000);
+
+// past the depth value() is trusted with, in the other types and in &&
+double half =
+$(chain h + 5000);
+string word =
+$(chain e + 5000)+"ab";
+int all =
+$(chain a '&&' 5000);
+END
@@ -0,0 +1,50 @@
+#!/bin/sh
+# writes t210.gpl: statements whose expressions are nested far deeper
+# than the evaluator can recurse
+. "$(dirname "$0")/chains.sh"
+
+cat <<END
+// statements whose expressions are nested far deeper than the evaluator
+// can recurse: each is compiled once when its statement is built and run
+// from there
+
+int a = 1;
+int m;
+int n;
+int count;
+double h = 0.5;
+double total;
+string e;
+string s;
+
+initialization
+{
+  // a left-deep chain of 60000 additions, assigned and added
+  m =
+$(chain a + 60000);
+  n +=
+$(chain a + 60000);
+
+  // and as a double
+  total -=
+$(chain h + 60000);
+
+  // and a string of 20000 pieces, appended and printed
+  s +=
+$(chain e + 20000)+"ab";
+  print(
+$(chain e + 20000)+"ab");
+
+  // 25000 levels of parentheses
+  n =
+$(nest '(' 'm + 1' ')' 25000);
+
+  // a condition of 60000 operands, in an if and a for
+  if (
+$(chain a '&&' 60000))
+    count++;
+  for (; count < 3 &&
+$(chain a '&&' 60000);)
+    count++;
+}
+END
@@ -0,0 +1,32 @@
+#!/bin/sh
+# writes t213.gpl: expressions nested far deeper than the evaluator can
+# recurse where a Bytecode used to hand them back to value()
+. "$(dirname "$0")/chains.sh"
+
+cat <<END
+// expressions nested far deeper than the evaluator can recurse where a
+// Bytecode used to hand them back to value(): array indexes, arguments to
+// random() and strings given to a builtin, in declarations and statements
+
+int o = 0;
+int a[4];
+string s = "x";
+double d = 1.5;
+int i = a[
+$(chain o + 60000) + 3];
+int r = random(
+$(chain o + 60000) + 4);
+
+initialization
+{
+  a[
+$(chain o + 60000) + 1] = a[
+$(chain o + 60000) + 2] + 10;
+  print(a[1]);
+  print(random(
+$(chain o + 60000) + 1) < 2);
+  d = sin(
+$(chain s + 60000) + "y");
+  print(d);
+}
+END
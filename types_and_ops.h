@@ -30,6 +30,19 @@ namespace gamelang {
 
   std::string to_string(gamelang::Type tp);
 
+  // true if a value of type from can be used where type to is expected:
+  // every type as itself, an int as a double, an int or double as a string
+  constexpr bool converts_to(Type from, Type to)
+  {
+    if (from == to)
+      return true;
+    if (to == DOUBLE)
+      return from == INT;
+    if (to == STRING)
+      return from == INT || from == DOUBLE;
+    return false;
+  }
+
 
   // NOTE: 
   //   ++ and -- are statements in Game Programming Language, 